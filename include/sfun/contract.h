@@ -1,6 +1,8 @@
 #ifndef STUFF_FROM_UNNAMED_NAMESPACE_V4_AND_NEWER_CONTRACT_H
 #define STUFF_FROM_UNNAMED_NAMESPACE_V4_AND_NEWER_CONTRACT_H
 
+#include "contract_handler.h"
+
 ///
 ///Renamed part of Microsoft.GSL assert header
 ///This header shouldn't contain any functions to support safe bundling with other libraries.
@@ -11,10 +13,104 @@
 #define _sfun_likely(x) (!!(x))
 #endif //defined(__clang__) || defined(__GNUC__)
 
-#define sfun_contract_check(cond) (_sfun_likely(cond) ? static_cast<void>(0) : std::terminate())
+///
+///Failed checks are reported through this hook, by default it calls the handler from contract_handler.h
+///and std::terminate(). It can be defined before including this header to report violations differently.
+///
+#ifndef _sfun_contract_violation
+#define _sfun_contract_violation(cond, file, line) ::sfun::detail::contractViolation(cond, file, line)
+#endif
+
+///
+///Contract levels, selected by defining SFUN_CONTRACT_LEVEL (or with the SFUN_CONTRACT_LEVEL CMake option):
+///SFUN_CONTRACT_LEVEL_OFF - checks aren't performed, their conditions are passed to the optimizer as assumptions,
+///                          so they must not have side effects;
+///SFUN_CONTRACT_LEVEL_DEFAULT - all checks except the audit ones are performed;
+///SFUN_CONTRACT_LEVEL_AUDIT - all checks are performed, including the expensive ones tagged with the _audit suffix.
+///Audit checks are discarded below the audit level.
+///Levels are non-zero, so a misspelled level that the preprocessor evaluates as 0 is reported instead of
+///being taken for SFUN_CONTRACT_LEVEL_OFF.
+///
+#define SFUN_CONTRACT_LEVEL_OFF 1
+#define SFUN_CONTRACT_LEVEL_DEFAULT 2
+#define SFUN_CONTRACT_LEVEL_AUDIT 3
+
+#ifndef SFUN_CONTRACT_LEVEL
+#define SFUN_CONTRACT_LEVEL SFUN_CONTRACT_LEVEL_DEFAULT
+#endif
+
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF && SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_DEFAULT &&          \
+        SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_AUDIT
+#error "Unknown SFUN_CONTRACT_LEVEL, use SFUN_CONTRACT_LEVEL_OFF, _DEFAULT or _AUDIT"
+#endif
+
+//__builtin_assume isn't used on clang as it warns about discarding conditions that call functions
+#if defined(__clang__) || defined(__GNUC__)
+#define _sfun_assume(cond) ((cond) ? static_cast<void>(0) : __builtin_unreachable())
+#elif defined(_MSC_VER)
+#define _sfun_assume(cond) __assume(cond)
+#else
+#define _sfun_assume(cond) static_cast<void>(0)
+#endif
+
+#define _sfun_contract_ignore(cond) static_cast<void>(sizeof(!(cond)))
+
+///
+///Defining SFUN_CONTRACT_PROFILING makes each performed check count its hits in a per-thread counter,
+///use sfun::contract_check_stats_top() or sfun::dump_contract_check_stats() from contract_profiling.h to read them.
+///Checks aren't counted during constant evaluation.
+///
+#ifdef SFUN_CONTRACT_PROFILING
+#include "contract_profiling.h"
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define _sfun_is_constant_evaluated() __builtin_is_constant_evaluated()
+#endif
+#endif
+#if !defined(_sfun_is_constant_evaluated) && defined(__GNUC__) && __GNUC__ >= 9
+#define _sfun_is_constant_evaluated() __builtin_is_constant_evaluated()
+#endif
+#if !defined(_sfun_is_constant_evaluated) && defined(_MSC_VER) && _MSC_VER >= 1925
+#define _sfun_is_constant_evaluated() __builtin_is_constant_evaluated()
+#endif
+#ifndef _sfun_is_constant_evaluated
+#define _sfun_is_constant_evaluated() false
+#endif
+
+#define _sfun_contract_count(cond)                                                                                     \
+    (_sfun_is_constant_evaluated() ? static_cast<void>(0)                                                              \
+                                   : []() -> ::sfun::detail::ContractSiteThreadCounter&                                \
+                                     {                                                                                 \
+                                         static auto site = ::sfun::detail::ContractSite{#cond, __FILE__, __LINE__};   \
+                                         thread_local auto counter = ::sfun::detail::ContractSiteThreadCounter{site};  \
+                                         return counter;                                                               \
+                                     }()                                                                               \
+                                             .increment())
+#else
+#define _sfun_contract_count(cond) static_cast<void>(0)
+#endif
+
+#if SFUN_CONTRACT_LEVEL == SFUN_CONTRACT_LEVEL_OFF
+#define sfun_contract_check(cond) _sfun_assume(cond)
+#else
+#define sfun_contract_check(cond)                                                                                      \
+    (_sfun_contract_count(cond),                                                                                       \
+     _sfun_likely(cond) ? static_cast<void>(0) : _sfun_contract_violation(#cond, __FILE__, __LINE__))
+#endif
+
+#if SFUN_CONTRACT_LEVEL == SFUN_CONTRACT_LEVEL_AUDIT
+#define sfun_contract_check_audit(cond) sfun_contract_check(cond)
+#else
+#define sfun_contract_check_audit(cond) _sfun_contract_ignore(cond)
+#endif
 
 #define sfun_precondition sfun_contract_check
 #define sfun_postcondition sfun_contract_check
 #define sfun_invariant sfun_contract_check
 
+#define sfun_precondition_audit sfun_contract_check_audit
+#define sfun_postcondition_audit sfun_contract_check_audit
+#define sfun_invariant_audit sfun_contract_check_audit
+
 #endif //STUFF_FROM_UNNAMED_NAMESPACE_V4_AND_NEWER_CONTRACT_H
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef SFUN_CONTRACT_HANDLER_H
+#define SFUN_CONTRACT_HANDLER_H
+
+#include <atomic>
+#include <cstdio>
+#include <exception>
+
+#if defined(__clang__) || defined(__GNUC__)
+#define _sfun_cold __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define _sfun_cold __declspec(noinline)
+#else
+#define _sfun_cold
+#endif //defined(__clang__) || defined(__GNUC__)
+
+namespace sfun {
+
+using contract_violation_handler = void (*)(const char* condition, const char* file, int line);
+
+namespace detail {
+
+inline std::atomic<contract_violation_handler> contractViolationHandler = nullptr;
+
+// The failure path is kept out of line, so check sites only contain a predicted branch and a call
+[[noreturn]] _sfun_cold inline void contractViolation(const char* condition, const char* file, int line)
+{
+    if (auto handler = contractViolationHandler.load(std::memory_order_acquire))
+        handler(condition, file, line);
+    else
+        std::fprintf(stderr, "%s:%d: contract violation: %s\n", file, line, condition);
+    std::terminate();
+}
+
+} //namespace detail
+
+/// Installs a handler called on contract violations before std::terminate() and returns the previous one.
+/// The handler can throw to recover from a violation, e.g. in tests.
+inline contract_violation_handler set_contract_violation_handler(contract_violation_handler handler)
+{
+    return detail::contractViolationHandler.exchange(handler, std::memory_order_acq_rel);
+}
+
+} //namespace sfun
+
+#endif //SFUN_CONTRACT_HANDLER_H
@@ -0,0 +1,155 @@
+#ifndef SFUN_CONTRACT_PROFILING_H
+#define SFUN_CONTRACT_PROFILING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace sfun {
+
+struct contract_check_stats {
+    const char* condition;
+    const char* file;
+    int line;
+    std::uint64_t hit_count;
+};
+
+namespace detail {
+
+class ContractSiteThreadCounter;
+
+class ContractSite {
+public:
+    ContractSite(const char* condition, const char* file, int line);
+
+    const char* condition;
+    const char* file;
+    int line;
+    // Hits of the finished threads
+    std::uint64_t retiredHitCount = 0;
+    std::vector<ContractSiteThreadCounter*> threadCounters;
+};
+
+struct ContractSiteRegistry {
+    std::mutex mutex;
+    std::vector<ContractSite*> sites;
+};
+
+inline ContractSiteRegistry& contractSiteRegistry()
+{
+    static auto registry = ContractSiteRegistry{};
+    return registry;
+}
+
+inline ContractSite::ContractSite(const char* condition, const char* file, int line)
+    : condition{condition}
+    , file{file}
+    , line{line}
+{
+    auto& registry = contractSiteRegistry();
+    auto lock = std::lock_guard{registry.mutex};
+    registry.sites.push_back(this);
+}
+
+// Counts the hits of a check site in the current thread, the count is only written by the owning thread,
+// so the increment doesn't need an atomic read-modify-write.
+class ContractSiteThreadCounter {
+public:
+    explicit ContractSiteThreadCounter(ContractSite& site)
+        : site_{site}
+    {
+        auto& registry = contractSiteRegistry();
+        auto lock = std::lock_guard{registry.mutex};
+        site_.threadCounters.push_back(this);
+    }
+
+    ~ContractSiteThreadCounter()
+    {
+        auto& registry = contractSiteRegistry();
+        auto lock = std::lock_guard{registry.mutex};
+        site_.retiredHitCount += hitCount();
+        auto& counters = site_.threadCounters;
+        counters.erase(std::remove(counters.begin(), counters.end(), this), counters.end());
+    }
+
+    ContractSiteThreadCounter(const ContractSiteThreadCounter&) = delete;
+    ContractSiteThreadCounter& operator=(const ContractSiteThreadCounter&) = delete;
+
+    void increment()
+    {
+        hitCount_.store(hitCount_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t hitCount() const
+    {
+        return hitCount_.load(std::memory_order_relaxed);
+    }
+
+private:
+    ContractSite& site_;
+    std::atomic<std::uint64_t> hitCount_ = 0;
+};
+
+} //namespace detail
+
+/// Returns hit counts of the contract check sites sorted in descending order, limited to maxCount sites.
+/// Sites are registered on the first hit when SFUN_CONTRACT_PROFILING is defined.
+/// Sites in templates are merged by their source location.
+inline std::vector<contract_check_stats> contract_check_stats_top(
+        std::size_t maxCount = std::numeric_limits<std::size_t>::max())
+{
+    auto result = std::vector<contract_check_stats>{};
+    {
+        auto& registry = detail::contractSiteRegistry();
+        auto lock = std::lock_guard{registry.mutex};
+        for (auto site : registry.sites) {
+            auto hitCount = site->retiredHitCount;
+            for (auto counter : site->threadCounters)
+                hitCount += counter->hitCount();
+
+            auto it = std::find_if(
+                    result.begin(),
+                    result.end(),
+                    [site](const contract_check_stats& stats)
+                    {
+                        return stats.line == site->line && std::strcmp(stats.file, site->file) == 0;
+                    });
+            if (it != result.end())
+                it->hit_count += hitCount;
+            else
+                result.push_back({site->condition, site->file, site->line, hitCount});
+        }
+    }
+    std::sort(
+            result.begin(),
+            result.end(),
+            [](const contract_check_stats& lhs, const contract_check_stats& rhs)
+            {
+                return lhs.hit_count > rhs.hit_count;
+            });
+    if (result.size() > maxCount)
+        result.resize(maxCount);
+    return result;
+}
+
+/// Prints the hit counts of maxCount most frequently executed contract check sites
+inline void dump_contract_check_stats(std::FILE* stream, std::size_t maxCount = 20)
+{
+    for (const auto& stats : contract_check_stats_top(maxCount))
+        std::fprintf(
+                stream,
+                "%20llu %s:%d: %s\n",
+                static_cast<unsigned long long>(stats.hit_count),
+                stats.file,
+                stats.line,
+                stats.condition);
+}
+
+} //namespace sfun
+
+#endif //SFUN_CONTRACT_PROFILING_H
@@ -0,0 +1,34 @@
+#ifndef SFUN_DETAIL_THREAD_STRIPES_H
+#define SFUN_DETAIL_THREAD_STRIPES_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace sfun {
+namespace detail {
+
+inline constexpr auto maxThreadStripeCount = std::size_t{16};
+
+// Number of counter stripes for data updated by every reading thread
+inline std::size_t threadStripeCount()
+{
+    return std::clamp(
+            static_cast<std::size_t>(std::thread::hardware_concurrency()),
+            std::size_t{1},
+            maxThreadStripeCount);
+}
+
+// Index of the calling thread, threads are spread over the stripes in the order of their first call
+inline std::size_t threadStripeIndex()
+{
+    static auto nextIndex = std::atomic<std::size_t>{};
+    thread_local const auto index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} //namespace detail
+} //namespace sfun
+
+#endif //SFUN_DETAIL_THREAD_STRIPES_H
@@ -0,0 +1,396 @@
+#ifndef SFUN_DIRECTORY_WALK_H
+#define SFUN_DIRECTORY_WALK_H
+
+#include "path.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sfun {
+
+namespace detail {
+
+class DirectoryWalkQueue {
+public:
+    explicit DirectoryWalkQueue(int workerCount)
+        : workerQueues_(static_cast<std::size_t>(workerCount))
+    {
+    }
+
+    void push(int workerIndex, std::string directory)
+    {
+        pendingCount_.fetch_add(1, std::memory_order_relaxed);
+        {
+            auto& queue = workerQueues_[static_cast<std::size_t>(workerIndex)];
+            auto lock = std::lock_guard{queue.mutex};
+            queue.directories.push_back(std::move(directory));
+        }
+
+        queuedCount_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepingWorkerCount_.load(std::memory_order_seq_cst) > 0) {
+            auto lock = std::lock_guard{sleepMutex_};
+            sleepCondition_.notify_one();
+        }
+    }
+
+    std::optional<std::string> pop(int workerIndex)
+    {
+        {
+            auto& queue = workerQueues_[static_cast<std::size_t>(workerIndex)];
+            auto lock = std::lock_guard{queue.mutex};
+            if (!queue.directories.empty()) {
+                auto directory = std::move(queue.directories.back());
+                queue.directories.pop_back();
+                queuedCount_.fetch_sub(1, std::memory_order_relaxed);
+                return directory;
+            }
+        }
+        const auto workerCount = static_cast<int>(workerQueues_.size());
+        for (auto i = 1; i < workerCount; ++i) {
+            auto& queue = workerQueues_[static_cast<std::size_t>((workerIndex + i) % workerCount)];
+            auto lock = std::lock_guard{queue.mutex};
+            if (!queue.directories.empty()) {
+                auto directory = std::move(queue.directories.front());
+                queue.directories.pop_front();
+                queuedCount_.fetch_sub(1, std::memory_order_relaxed);
+                return directory;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void markDone()
+    {
+        if (pendingCount_.fetch_sub(1, std::memory_order_seq_cst) == 1)
+            wakeAll();
+    }
+
+    void stop(std::exception_ptr error)
+    {
+        {
+            auto lock = std::lock_guard{errorMutex_};
+            if (!error_)
+                error_ = std::move(error);
+            isStopped_.store(true, std::memory_order_seq_cst);
+        }
+        wakeAll();
+    }
+
+    bool isFinished() const
+    {
+        return pendingCount_.load(std::memory_order_seq_cst) == 0 || isStopped_.load(std::memory_order_seq_cst);
+    }
+
+    void waitForWork()
+    {
+        auto lock = std::unique_lock{sleepMutex_};
+        sleepingWorkerCount_.fetch_add(1, std::memory_order_seq_cst);
+        sleepCondition_.wait(
+                lock,
+                [this]
+                {
+                    return queuedCount_.load(std::memory_order_seq_cst) > 0 || isFinished();
+                });
+        sleepingWorkerCount_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    std::exception_ptr error() const
+    {
+        return error_;
+    }
+
+private:
+    void wakeAll()
+    {
+        // Taking the mutex orders the state change with the predicate check of a worker that's about to sleep
+        {
+            auto lock = std::lock_guard{sleepMutex_};
+        }
+        sleepCondition_.notify_all();
+    }
+
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::string> directories;
+    };
+
+    std::vector<WorkerQueue> workerQueues_;
+    std::atomic<std::ptrdiff_t> pendingCount_ = 0;
+    std::atomic<std::ptrdiff_t> queuedCount_ = 0;
+    std::atomic<int> sleepingWorkerCount_ = 0;
+    std::atomic<bool> isStopped_ = false;
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondition_;
+};
+
+// Directories removed during the walk or inaccessible ones are skipped, other errors stop the walk
+inline void handleDirectoryReadError(const std::string& directory, std::error_code ec)
+{
+    if (ec == std::errc::no_such_file_or_directory || ec == std::errc::permission_denied ||
+        ec == std::errc::not_a_directory)
+        return;
+    throw std::filesystem::filesystem_error{"sfun::walk_directory", make_path(directory), ec};
+}
+
+inline std::string joinDirectoryPath(std::string_view directory, std::string_view name)
+{
+    auto result = std::string{};
+    result.reserve(directory.size() + name.size() + 1);
+    result += directory;
+    if (!result.empty() && result.back() != '/')
+        result += '/';
+    result += name;
+    return result;
+}
+
+#ifdef __linux__
+
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd)
+        : fd_{fd}
+    {
+    }
+    ~FileDescriptor()
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const
+    {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+// linux_dirent64 record layout: d_ino (8 bytes), d_off (8 bytes), d_reclen (2 bytes), d_type (1 byte), d_name
+inline constexpr auto direntRecordLengthOffset = 16;
+inline constexpr auto direntTypeOffset = 18;
+inline constexpr auto direntNameOffset = 19;
+
+struct DirectoryWalkBuffers {
+    std::vector<char> direntBuffer = std::vector<char>(64 * 1024);
+    std::vector<std::string_view> names;
+};
+
+inline bool isSubdirectory(int directoryFd, const char* name, unsigned char type)
+{
+    if (type != DT_UNKNOWN)
+        return type == DT_DIR;
+
+    struct stat entryStat = {};
+    if (::fstatat(directoryFd, name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0)
+        return false;
+    return S_ISDIR(entryStat.st_mode);
+}
+
+template<typename TBatchHandler>
+void readDirectory(
+        const std::string& directory,
+        TBatchHandler& batchHandler,
+        DirectoryWalkQueue& queue,
+        int workerIndex,
+        DirectoryWalkBuffers& buffers)
+{
+    const auto fd = FileDescriptor{::openat(AT_FDCWD, directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+    if (fd.get() < 0) {
+        handleDirectoryReadError(directory, std::error_code{errno, std::generic_category()});
+        return;
+    }
+
+    auto& buffer = buffers.direntBuffer;
+    auto& names = buffers.names;
+    while (true) {
+        const auto bytesRead = ::syscall(SYS_getdents64, fd.get(), buffer.data(), buffer.size());
+        if (bytesRead < 0) {
+            handleDirectoryReadError(directory, std::error_code{errno, std::generic_category()});
+            return;
+        }
+        if (bytesRead == 0)
+            return;
+
+        names.clear();
+        for (auto offset = long{}; offset < bytesRead;) {
+            const auto* record = buffer.data() + offset;
+            auto recordLength = std::uint16_t{};
+            std::memcpy(&recordLength, record + direntRecordLengthOffset, sizeof(recordLength));
+            offset += recordLength;
+
+            const auto* entryName = record + direntNameOffset;
+            const auto name = std::string_view{entryName};
+            if (name == "." || name == "..")
+                continue;
+
+            names.push_back(name);
+            const auto type = static_cast<unsigned char>(record[direntTypeOffset]);
+            if (isSubdirectory(fd.get(), entryName, type))
+                queue.push(workerIndex, joinDirectoryPath(directory, name));
+        }
+        if (!names.empty())
+            batchHandler(std::string_view{directory}, std::as_const(names));
+    }
+}
+
+#else
+
+inline constexpr auto directoryWalkBatchSize = std::size_t{256};
+
+struct DirectoryWalkBuffers {
+    std::vector<std::string> nameStorage = std::vector<std::string>(directoryWalkBatchSize);
+    std::vector<std::string_view> names;
+};
+
+template<typename TBatchHandler>
+void readDirectory(
+        const std::string& directory,
+        TBatchHandler& batchHandler,
+        DirectoryWalkQueue& queue,
+        int workerIndex,
+        DirectoryWalkBuffers& buffers)
+{
+    auto& nameStorage = buffers.nameStorage;
+    auto& names = buffers.names;
+    auto storedCount = std::size_t{};
+    auto flush = [&]
+    {
+        if (storedCount == 0)
+            return;
+        names.clear();
+        for (auto i = std::size_t{}; i < storedCount; ++i)
+            names.push_back(nameStorage[i]);
+        storedCount = 0;
+        batchHandler(std::string_view{directory}, std::as_const(names));
+    };
+
+    auto ec = std::error_code{};
+    for (auto it = std::filesystem::directory_iterator{make_path(directory), ec};
+         !ec && it != std::filesystem::directory_iterator{};
+         it.increment(ec)) {
+        nameStorage[storedCount] = path_string(it->path().filename());
+        auto entryEc = std::error_code{};
+        if (it->is_directory(entryEc) && !it->is_symlink(entryEc))
+            queue.push(workerIndex, joinDirectoryPath(directory, nameStorage[storedCount]));
+        if (++storedCount == directoryWalkBatchSize)
+            flush();
+    }
+    flush();
+    if (ec)
+        handleDirectoryReadError(directory, ec);
+}
+
+#endif //__linux__
+
+template<typename TBatchHandler>
+void runDirectoryWalkWorker(TBatchHandler& batchHandler, DirectoryWalkQueue& queue, int workerIndex)
+{
+    constexpr auto spinCount = 64;
+    try {
+        auto buffers = DirectoryWalkBuffers{};
+        auto idleCount = 0;
+        while (!queue.isFinished()) {
+            auto directory = queue.pop(workerIndex);
+            if (!directory) {
+                if (++idleCount < spinCount)
+                    std::this_thread::yield();
+                else {
+                    queue.waitForWork();
+                    idleCount = 0;
+                }
+                continue;
+            }
+            idleCount = 0;
+            readDirectory(*directory, batchHandler, queue, workerIndex, buffers);
+            queue.markDone();
+        }
+    }
+    catch (...) {
+        queue.stop(std::current_exception());
+    }
+}
+
+} //namespace detail
+
+///
+/// Recursively enumerates the directory tree at root using threadCount workers (hardware concurrency when 0).
+/// batchHandler(std::string_view directory, const std::vector<std::string_view>& names) is invoked concurrently
+/// from all workers; the names are only valid for the duration of the call.
+/// Symlinks to directories aren't followed, subdirectories that are inaccessible or removed during the walk
+/// are skipped. Other errors of reading a directory stop the walk and are rethrown as filesystem_error.
+///
+template<typename TBatchHandler>
+void walk_directory(const std::filesystem::path& root, TBatchHandler&& batchHandler, int threadCount = 0)
+{
+    if (!std::filesystem::is_directory(root))
+        throw std::filesystem::filesystem_error{
+                "sfun::walk_directory",
+                root,
+                std::make_error_code(std::errc::not_a_directory)};
+
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    auto queue = detail::DirectoryWalkQueue{threadCount};
+    queue.push(0, path_string(root));
+
+    auto workers = std::vector<std::thread>{};
+    auto joinWorkers = [&workers]
+    {
+        for (auto& worker : workers)
+            worker.join();
+    };
+    try {
+        workers.reserve(static_cast<std::size_t>(threadCount - 1));
+        for (auto i = 1; i < threadCount; ++i)
+            workers.emplace_back(
+                    [&, i]
+                    {
+                        detail::runDirectoryWalkWorker(batchHandler, queue, i);
+                    });
+    }
+    catch (...) {
+        // Workers that did start may be asleep waiting for directories: stopping the queue wakes them,
+        // so they can be joined before the vector destroys their joinable threads and calls std::terminate()
+        queue.stop(std::current_exception());
+        joinWorkers();
+        throw;
+    }
+    detail::runDirectoryWalkWorker(batchHandler, queue, 0);
+    joinWorkers();
+
+    if (auto error = queue.error())
+        std::rethrow_exception(error);
+}
+
+} //namespace sfun
+
+#endif //SFUN_DIRECTORY_WALK_H
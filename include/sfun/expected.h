@@ -0,0 +1,222 @@
+#ifndef SFUN_EXPECTED_H
+#define SFUN_EXPECTED_H
+
+#include "contract.h"
+#include <exception>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace sfun {
+
+template<typename E>
+class unexpected {
+    static_assert(!std::is_reference_v<E>, "unexpected type can't be a reference");
+
+public:
+    constexpr explicit unexpected(const E& error)
+        : error_{error}
+    {
+    }
+
+    constexpr explicit unexpected(E&& error)
+        : error_{std::move(error)}
+    {
+    }
+
+    constexpr const E& error() const& noexcept
+    {
+        return error_;
+    }
+
+    constexpr E& error() & noexcept
+    {
+        return error_;
+    }
+
+    constexpr E&& error() && noexcept
+    {
+        return std::move(error_);
+    }
+
+private:
+    E error_;
+};
+
+template<typename E>
+unexpected(E) -> unexpected<E>;
+
+namespace detail {
+
+template<typename T>
+struct ExpectedValueStorage {
+    using type = T;
+};
+
+template<typename T>
+struct ExpectedValueStorage<T&> {
+    using type = std::reference_wrapper<T>;
+};
+
+template<>
+struct ExpectedValueStorage<void> {
+    using type = std::monostate;
+};
+
+} //namespace detail
+
+///
+/// A C++17 implementation of a subset of std::expected, which also supports reference value types.
+/// Accessing a missing value or error is a precondition violation.
+///
+template<typename T, typename E>
+class expected {
+    static_assert(!std::is_reference_v<E>, "expected error type can't be a reference");
+    using value_storage = typename detail::ExpectedValueStorage<T>::type;
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    template<typename TCheck = T, std::enable_if_t<std::is_void_v<TCheck>>* = nullptr>
+    constexpr expected() noexcept
+        : storage_{std::in_place_index<0>}
+    {
+    }
+
+    template<
+            typename U,
+            typename TCheck = T,
+            std::enable_if_t<
+                    !std::is_void_v<TCheck> && !std::is_reference_v<TCheck> &&
+                    std::is_constructible_v<TCheck, U&&> &&
+                    !std::is_same_v<std::decay_t<U>, expected>>* = nullptr>
+    constexpr expected(U&& value)
+        : storage_{std::in_place_index<0>, std::forward<U>(value)}
+    {
+    }
+
+    template<typename U, typename TCheck = T, std::enable_if_t<std::is_reference_v<TCheck>>* = nullptr>
+    constexpr expected(U& value) noexcept
+        : storage_{std::in_place_index<0>, std::ref(value)}
+    {
+        static_assert(std::is_convertible_v<U&, TCheck>, "expected reference can't be bound to this value");
+    }
+
+    template<typename G>
+    constexpr expected(const unexpected<G>& error)
+        : storage_{std::in_place_index<1>, error.error()}
+    {
+    }
+
+    template<typename G>
+    constexpr expected(unexpected<G>&& error)
+        : storage_{std::in_place_index<1>, std::move(error).error()}
+    {
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+        return storage_.index() == 0;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    constexpr decltype(auto) value() &
+    {
+        sfun_precondition(has_value());
+        return valueRef(*this);
+    }
+
+    constexpr decltype(auto) value() const&
+    {
+        sfun_precondition(has_value());
+        return valueRef(*this);
+    }
+
+    constexpr decltype(auto) value() &&
+    {
+        sfun_precondition(has_value());
+        if constexpr (std::is_void_v<T> || std::is_reference_v<T>)
+            return valueRef(*this);
+        else
+            return std::move(std::get<0>(storage_));
+    }
+
+    constexpr decltype(auto) operator*() &
+    {
+        return value();
+    }
+
+    constexpr decltype(auto) operator*() const&
+    {
+        return value();
+    }
+
+    constexpr decltype(auto) operator*() &&
+    {
+        return std::move(*this).value();
+    }
+
+    template<typename TCheck = T, std::enable_if_t<!std::is_void_v<TCheck>>* = nullptr>
+    constexpr auto operator->()
+    {
+        return std::addressof(value());
+    }
+
+    template<typename TCheck = T, std::enable_if_t<!std::is_void_v<TCheck>>* = nullptr>
+    constexpr auto operator->() const
+    {
+        return std::addressof(value());
+    }
+
+    template<typename U, typename TCheck = T, std::enable_if_t<!std::is_void_v<TCheck>>* = nullptr>
+    constexpr std::remove_cv_t<std::remove_reference_t<TCheck>> value_or(U&& defaultValue) const&
+    {
+        if (has_value())
+            return valueRef(*this);
+        return static_cast<std::remove_cv_t<std::remove_reference_t<TCheck>>>(std::forward<U>(defaultValue));
+    }
+
+    constexpr const E& error() const&
+    {
+        sfun_precondition(!has_value());
+        return std::get<1>(storage_);
+    }
+
+    constexpr E& error() &
+    {
+        sfun_precondition(!has_value());
+        return std::get<1>(storage_);
+    }
+
+    constexpr E&& error() &&
+    {
+        sfun_precondition(!has_value());
+        return std::move(std::get<1>(storage_));
+    }
+
+private:
+    template<typename TSelf>
+    static constexpr decltype(auto) valueRef(TSelf& self)
+    {
+        if constexpr (std::is_void_v<T>)
+            return;
+        else if constexpr (std::is_reference_v<T>)
+            return static_cast<T>(std::get<0>(self.storage_).get());
+        else
+            return (std::get<0>(self.storage_));
+    }
+
+private:
+    std::variant<value_storage, E> storage_;
+};
+
+} //namespace sfun
+
+#endif //SFUN_EXPECTED_H
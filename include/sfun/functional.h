@@ -1,9 +1,16 @@
 #ifndef SFUN_FUNCTIONAL_H
 #define SFUN_FUNCTIONAL_H
 
+#include "expected.h"
 #include "type_list.h"
+#include <cstddef>
+#include <exception>
 #include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
+#include <variant>
 
 namespace sfun {
 
@@ -90,6 +97,250 @@ template<typename TCallable>
 using callable_return_type =
         typename callable_signature<decltype(detail::callable_storage{std::declval<TCallable>()})>::return_type;
 
+namespace detail {
+
+template<typename F>
+inline constexpr auto isRvalueMemberPointer =
+        !std::is_lvalue_reference_v<F> && std::is_member_pointer_v<std::remove_reference_t<F>>;
+
+} //namespace detail
+
+template<typename Signature>
+class function_ref;
+
+///
+/// A non-owning reference to a callable, consisting of two pointers and trivially copyable.
+/// The referenced callable must outlive the function_ref.
+/// Member pointers are referenced too, so they can't be bound from temporaries like &Class::method.
+///
+template<typename R, typename... Args>
+class function_ref<R(Args...)> {
+    union Storage {
+        void* object;
+        void (*function)();
+    };
+
+public:
+    template<
+            typename F,
+            std::enable_if_t<
+                    !std::is_same_v<std::decay_t<F>, function_ref> &&
+                    !detail::isRvalueMemberPointer<F> &&
+                    std::is_invocable_r_v<R, std::remove_reference_t<F>&, Args...>>* = nullptr>
+    function_ref(F&& f) noexcept
+    {
+        using TCallable = std::remove_reference_t<F>;
+        if constexpr (std::is_function_v<TCallable>) {
+            storage_.function = reinterpret_cast<void (*)()>(&f);
+            callback_ = [](Storage storage, Args... args) -> R
+            {
+                return invoke<TCallable&>(*reinterpret_cast<TCallable*>(storage.function), std::forward<Args>(args)...);
+            };
+        }
+        else if constexpr (std::is_pointer_v<TCallable> && std::is_function_v<std::remove_pointer_t<TCallable>>) {
+            storage_.function = reinterpret_cast<void (*)()>(f);
+            callback_ = [](Storage storage, Args... args) -> R
+            {
+                return invoke<TCallable>(reinterpret_cast<TCallable>(storage.function), std::forward<Args>(args)...);
+            };
+        }
+        else {
+            storage_.object = const_cast<void*>(static_cast<const volatile void*>(std::addressof(f)));
+            callback_ = [](Storage storage, Args... args) -> R
+            {
+                return invoke<TCallable&>(*static_cast<TCallable*>(storage.object), std::forward<Args>(args)...);
+            };
+        }
+    }
+
+    template<typename F, std::enable_if_t<detail::isRvalueMemberPointer<F>>* = nullptr>
+    function_ref(F&&) = delete;
+
+    R operator()(Args... args) const
+    {
+        return callback_(storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    template<typename F>
+    static R invoke(F f, Args... args)
+    {
+        if constexpr (std::is_void_v<R>)
+            std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+        else
+            return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+private:
+    Storage storage_;
+    R (*callback_)(Storage, Args...);
+};
+
+template<typename R, typename... Args>
+function_ref(R (*)(Args...)) -> function_ref<R(Args...)>;
+
+template<
+        typename F,
+        typename Signature =
+                typename detail::function_guide_helper<decltype(&std::remove_reference_t<F>::operator())>::type>
+function_ref(F&&) -> function_ref<Signature>;
+
+namespace detail {
+
+template<bool IsNoexcept, typename R, std::size_t Capacity, std::size_t Alignment, typename... Args>
+class InplaceFunctionBase {
+    struct VTable {
+        R (*invoke)(void* target, Args&&... args) noexcept(IsNoexcept);
+        void (*move)(void* dst, void* src) noexcept;
+        void (*destroy)(void* target) noexcept;
+    };
+
+    template<typename F>
+    static constexpr auto targetVTable = VTable{
+            [](void* target, Args&&... args) noexcept(IsNoexcept) -> R
+            {
+                if constexpr (std::is_void_v<R>)
+                    std::invoke(*static_cast<F*>(target), std::forward<Args>(args)...);
+                else
+                    return std::invoke(*static_cast<F*>(target), std::forward<Args>(args)...);
+            },
+            [](void* dst, void* src) noexcept
+            {
+                ::new (dst) F(std::move(*static_cast<F*>(src)));
+                static_cast<F*>(src)->~F();
+            },
+            [](void* target) noexcept
+            {
+                static_cast<F*>(target)->~F();
+            }};
+
+    static constexpr auto emptyVTable = VTable{
+            [](void*, Args&&...) noexcept(IsNoexcept) -> R
+            {
+                std::terminate();
+            },
+            [](void*, void*) noexcept {},
+            [](void*) noexcept {}};
+
+public:
+    InplaceFunctionBase() noexcept = default;
+
+    template<typename F>
+    explicit InplaceFunctionBase(std::in_place_type_t<F>, F&& f)
+    {
+        using TTarget = std::decay_t<F>;
+        static_assert(sizeof(TTarget) <= Capacity, "sfun::inplace_function capacity is too small for the callable");
+        static_assert(
+                Alignment % alignof(TTarget) == 0,
+                "sfun::inplace_function alignment is too small for the callable");
+        static_assert(
+                std::is_nothrow_move_constructible_v<TTarget>,
+                "sfun::inplace_function requires a nothrow move constructible callable");
+        // Like std::function, null function and member pointers produce an empty object
+        if constexpr (std::is_pointer_v<std::remove_reference_t<F>> || std::is_member_pointer_v<TTarget>)
+            if (f == nullptr)
+                return;
+        ::new (static_cast<void*>(storage_)) TTarget(std::forward<F>(f));
+        vtable_ = &targetVTable<TTarget>;
+    }
+
+    InplaceFunctionBase(InplaceFunctionBase&& other) noexcept
+        : vtable_{other.vtable_}
+    {
+        vtable_->move(storage_, other.storage_);
+        other.vtable_ = &emptyVTable;
+    }
+
+    InplaceFunctionBase& operator=(InplaceFunctionBase&& other) noexcept
+    {
+        if (this != &other) {
+            vtable_->destroy(storage_);
+            vtable_ = other.vtable_;
+            vtable_->move(storage_, other.storage_);
+            other.vtable_ = &emptyVTable;
+        }
+        return *this;
+    }
+
+    InplaceFunctionBase(const InplaceFunctionBase&) = delete;
+    InplaceFunctionBase& operator=(const InplaceFunctionBase&) = delete;
+
+    ~InplaceFunctionBase()
+    {
+        vtable_->destroy(storage_);
+    }
+
+    void reset() noexcept
+    {
+        vtable_->destroy(storage_);
+        vtable_ = &emptyVTable;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return vtable_ != &emptyVTable;
+    }
+
+    R operator()(Args... args) const noexcept(IsNoexcept)
+    {
+        return vtable_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    const VTable* vtable_ = &emptyVTable;
+    alignas(Alignment) mutable unsigned char storage_[Capacity];
+};
+
+} //namespace detail
+
+template<typename Signature, std::size_t Capacity = 32, std::size_t Alignment = alignof(std::max_align_t)>
+class inplace_function;
+
+///
+/// A move-only owning callable wrapper, which stores the callable in an inline buffer and never allocates.
+/// Callables that don't fit in Capacity bytes or require stricter alignment than Alignment fail to compile.
+/// Calling an empty inplace_function leads to std::terminate().
+///
+template<typename R, typename... Args, std::size_t Capacity, std::size_t Alignment>
+class inplace_function<R(Args...), Capacity, Alignment>
+    : public detail::InplaceFunctionBase<false, R, Capacity, Alignment, Args...> {
+    using base = detail::InplaceFunctionBase<false, R, Capacity, Alignment, Args...>;
+
+public:
+    inplace_function() noexcept = default;
+    inplace_function(std::nullptr_t) noexcept {}
+
+    template<
+            typename F,
+            std::enable_if_t<
+                    !std::is_same_v<std::decay_t<F>, inplace_function> &&
+                    std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>* = nullptr>
+    inplace_function(F&& f)
+        : base{std::in_place_type<F>, std::forward<F>(f)}
+    {
+    }
+};
+
+template<typename R, typename... Args, std::size_t Capacity, std::size_t Alignment>
+class inplace_function<R(Args...) noexcept, Capacity, Alignment>
+    : public detail::InplaceFunctionBase<true, R, Capacity, Alignment, Args...> {
+    using base = detail::InplaceFunctionBase<true, R, Capacity, Alignment, Args...>;
+
+public:
+    inplace_function() noexcept = default;
+    inplace_function(std::nullptr_t) noexcept {}
+
+    template<
+            typename F,
+            std::enable_if_t<
+                    !std::is_same_v<std::decay_t<F>, inplace_function> &&
+                    std::is_nothrow_invocable_r_v<R, std::decay_t<F>&, Args...>>* = nullptr>
+    inplace_function(F&& f)
+        : base{std::in_place_type<F>, std::forward<F>(f)}
+    {
+    }
+};
+
 template<class... Ts>
 struct overloaded : Ts... {
     using Ts::operator()...;
@@ -97,6 +348,77 @@ struct overloaded : Ts... {
 template<class... Ts>
 overloaded(Ts...) -> overloaded<Ts...>;
 
+namespace detail {
+
+template<typename TVariant>
+inline constexpr auto variantSize = std::variant_size_v<std::remove_cv_t<std::remove_reference_t<TVariant>>>;
+
+// Variant indices are combined into a single index, the last variant's index changes the fastest.
+template<typename... TVariants>
+constexpr std::size_t flatVariantIndex(const TVariants&... variants)
+{
+    auto result = std::size_t{};
+    ((result = result * variantSize<TVariants> + variants.index()), ...);
+    return result;
+}
+
+template<std::size_t FlatIndex, std::size_t VariantIndex, typename... TVariants>
+constexpr std::size_t alternativeIndex()
+{
+    constexpr std::size_t sizes[] = {variantSize<TVariants>...};
+    auto stride = std::size_t{1};
+    for (auto i = VariantIndex + 1; i < sizeof...(TVariants); ++i)
+        stride *= sizes[i];
+    return FlatIndex / stride % sizes[VariantIndex];
+}
+
+template<std::size_t FlatIndex, typename F, std::size_t... VariantIndex, typename... TVariants>
+constexpr decltype(auto) invokeWithAlternatives(F&& f, std::index_sequence<VariantIndex...>, TVariants&&... variants)
+{
+    return std::forward<F>(f)(
+            std::get<alternativeIndex<FlatIndex, VariantIndex, TVariants...>()>(std::forward<TVariants>(variants))...);
+}
+
+template<typename F, typename... TVariants>
+constexpr decltype(auto) visitVariants(F&& f, TVariants&&... variants)
+{
+    if ((variants.valueless_by_exception() || ...))
+        throw std::bad_variant_access{};
+
+    return dispatchIndex<(variantSize<TVariants> * ...)>(
+            flatVariantIndex(variants...),
+            [&](auto flatIndex) -> decltype(auto)
+            {
+                return invokeWithAlternatives<decltype(flatIndex)::value>(
+                        std::forward<F>(f),
+                        std::index_sequence_for<TVariants...>{},
+                        std::forward<TVariants>(variants)...);
+            });
+}
+
+template<typename TArgs, std::size_t... I>
+constexpr decltype(auto) visitWithLastArgVisitor(TArgs&& args, std::index_sequence<I...>)
+{
+    return visitVariants(std::get<sizeof...(I)>(std::move(args)), std::get<I>(std::move(args))...);
+}
+
+} //namespace detail
+
+///
+/// Visits one or more variants with the visitor passed as the last argument, usually sfun::overloaded:
+///    sfun::visit(variant, sfun::overloaded{...});
+/// Unlike std::visit, the alternatives are dispatched with a switch on index() when there are up to 64 combinations,
+/// so the visitor can be inlined. Larger variants fall back to a table of function pointers.
+///
+template<typename... TArgs>
+constexpr decltype(auto) visit(TArgs&&... args)
+{
+    static_assert(sizeof...(TArgs) > 1, "sfun::visit requires at least one variant followed by a visitor");
+    return detail::visitWithLastArgVisitor(
+            std::forward_as_tuple(std::forward<TArgs>(args)...),
+            std::make_index_sequence<sizeof...(TArgs) - 1>{});
+}
+
 template<typename F, typename... Args>
 auto try_invoke(F&& f, Args&&... args) noexcept
 {
@@ -119,6 +441,46 @@ auto try_invoke(F&& f, Args&&... args) noexcept
     }
 }
 
+namespace detail {
+template<typename R>
+using try_invoke_expected_value_t = std::conditional_t<std::is_rvalue_reference_v<R>, std::remove_reference_t<R>, R>;
+}
+
+///
+/// Invokes f and returns its result in sfun::expected, with a caught exception stored as the error.
+/// Lvalue references are returned without copying, rvalue references are moved into the result.
+/// If f is noexcept, no try block is used.
+///
+template<typename F, typename... Args>
+auto try_invoke_expected(F&& f, Args&&... args) noexcept
+        -> expected<detail::try_invoke_expected_value_t<std::invoke_result_t<F, Args...>>, std::exception_ptr>
+{
+    using result_type = std::invoke_result_t<F, Args...>;
+    using expected_type = expected<detail::try_invoke_expected_value_t<result_type>, std::exception_ptr>;
+
+    if constexpr (std::is_nothrow_invocable_v<F, Args...>) {
+        if constexpr (std::is_void_v<result_type>) {
+            std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+            return expected_type{};
+        }
+        else
+            return expected_type{std::invoke(std::forward<F>(f), std::forward<Args>(args)...)};
+    }
+    else {
+        try {
+            if constexpr (std::is_void_v<result_type>) {
+                std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+                return expected_type{};
+            }
+            else
+                return expected_type{std::invoke(std::forward<F>(f), std::forward<Args>(args)...)};
+        }
+        catch (...) {
+            return expected_type{unexpected{std::current_exception()}};
+        }
+    }
+}
+
 } //namespace sfun
 
 #endif //SFUN_FUNCTIONAL_H
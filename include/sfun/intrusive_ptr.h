@@ -0,0 +1,256 @@
+#ifndef SFUN_INTRUSIVE_PTR_H
+#define SFUN_INTRUSIVE_PTR_H
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace sfun {
+
+enum class ref_counting {
+    atomic,
+    single_threaded
+};
+
+namespace detail {
+
+template<ref_counting Policy>
+class RefCounter;
+
+template<>
+class RefCounter<ref_counting::atomic> {
+public:
+    void increment()
+    {
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Returns true when the last reference is released
+    bool decrement()
+    {
+        return count_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    std::size_t count() const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::size_t> count_ = 0;
+};
+
+template<>
+class RefCounter<ref_counting::single_threaded> {
+public:
+    void increment()
+    {
+        ++count_;
+    }
+
+    bool decrement()
+    {
+        return --count_ == 0;
+    }
+
+    std::size_t count() const
+    {
+        return count_;
+    }
+
+private:
+    std::size_t count_ = 0;
+};
+
+} //namespace detail
+
+///
+/// A base class embedding the reference counter used by sfun::intrusive_ptr into TDerived.
+/// Copying the object doesn't copy its reference count.
+///
+template<typename TDerived, ref_counting Policy = ref_counting::atomic>
+class ref_counted {
+public:
+    std::size_t ref_count() const
+    {
+        return counter_.count();
+    }
+
+protected:
+    ref_counted() = default;
+    ~ref_counted() = default;
+
+    ref_counted(const ref_counted&)
+    {
+    }
+
+    ref_counted& operator=(const ref_counted&)
+    {
+        return *this;
+    }
+
+private:
+    friend void intrusive_ptr_add_ref(const ref_counted* object)
+    {
+        object->counter_.increment();
+    }
+
+    friend void intrusive_ptr_release(const ref_counted* object)
+    {
+        if (object->counter_.decrement())
+            delete static_cast<const TDerived*>(object);
+    }
+
+private:
+    mutable detail::RefCounter<Policy> counter_;
+};
+
+///
+/// A smart pointer to an object storing its own reference count, usually by deriving from sfun::ref_counted.
+/// The counter is updated with intrusive_ptr_add_ref(T*) and intrusive_ptr_release(T*) functions found by ADL,
+/// so the pointer takes no extra allocation for a control block and has the size of a raw pointer.
+///
+template<typename T>
+class intrusive_ptr {
+public:
+    using element_type = T;
+
+    intrusive_ptr() = default;
+
+    intrusive_ptr(std::nullptr_t)
+    {
+    }
+
+    explicit intrusive_ptr(T* ptr, bool addRef = true)
+        : ptr_{ptr}
+    {
+        if (ptr_ && addRef)
+            intrusive_ptr_add_ref(ptr_);
+    }
+
+    intrusive_ptr(const intrusive_ptr& other)
+        : intrusive_ptr{other.ptr_}
+    {
+    }
+
+    intrusive_ptr(intrusive_ptr&& other) noexcept
+        : ptr_{std::exchange(other.ptr_, nullptr)}
+    {
+    }
+
+    template<typename U, std::enable_if_t<std::is_convertible_v<U*, T*>>* = nullptr>
+    intrusive_ptr(const intrusive_ptr<U>& other)
+        : intrusive_ptr{other.get()}
+    {
+    }
+
+    template<typename U, std::enable_if_t<std::is_convertible_v<U*, T*>>* = nullptr>
+    intrusive_ptr(intrusive_ptr<U>&& other) noexcept
+        : ptr_{other.detach()}
+    {
+    }
+
+    ~intrusive_ptr()
+    {
+        if (ptr_)
+            intrusive_ptr_release(ptr_);
+    }
+
+    intrusive_ptr& operator=(const intrusive_ptr& other)
+    {
+        intrusive_ptr{other}.swap(*this);
+        return *this;
+    }
+
+    intrusive_ptr& operator=(intrusive_ptr&& other) noexcept
+    {
+        intrusive_ptr{std::move(other)}.swap(*this);
+        return *this;
+    }
+
+    void reset(T* ptr = nullptr)
+    {
+        intrusive_ptr{ptr}.swap(*this);
+    }
+
+    /// Releases the ownership without decrementing the reference count
+    T* detach() noexcept
+    {
+        return std::exchange(ptr_, nullptr);
+    }
+
+    void swap(intrusive_ptr& other) noexcept
+    {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    T* get() const noexcept
+    {
+        return ptr_;
+    }
+
+    T& operator*() const noexcept
+    {
+        return *ptr_;
+    }
+
+    T* operator->() const noexcept
+    {
+        return ptr_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ptr_ != nullptr;
+    }
+
+private:
+    T* ptr_ = nullptr;
+};
+
+template<typename T, typename U>
+bool operator==(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+
+template<typename T, typename U>
+bool operator!=(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+{
+    return lhs.get() != rhs.get();
+}
+
+template<typename T>
+bool operator==(const intrusive_ptr<T>& lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() == nullptr;
+}
+
+template<typename T>
+bool operator!=(const intrusive_ptr<T>& lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() != nullptr;
+}
+
+template<typename T>
+bool operator==(std::nullptr_t, const intrusive_ptr<T>& rhs) noexcept
+{
+    return rhs.get() == nullptr;
+}
+
+template<typename T>
+bool operator!=(std::nullptr_t, const intrusive_ptr<T>& rhs) noexcept
+{
+    return rhs.get() != nullptr;
+}
+
+template<typename T, typename... TArgs>
+intrusive_ptr<T> make_intrusive(TArgs&&... args)
+{
+    return intrusive_ptr<T>{new T(std::forward<TArgs>(args)...)};
+}
+
+} //namespace sfun
+
+#endif //SFUN_INTRUSIVE_PTR_H
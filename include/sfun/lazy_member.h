@@ -0,0 +1,438 @@
+#ifndef SFUN_LAZY_MEMBER_H
+#define SFUN_LAZY_MEMBER_H
+
+#include "contract.h"
+#include "member.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace sfun {
+
+enum class lazy_init {
+    thread_safe,
+    single_threaded
+};
+
+namespace detail {
+
+enum class LazyMemberState : std::uint8_t {
+    Empty,
+    Initializing,
+    InitializingWithWaiters,
+    Initialized
+};
+
+// Members being initialized by the current thread, the frames live on the stack of LazyMemberInitScope
+struct LazyMemberInitFrame {
+    const void* member;
+    const LazyMemberInitFrame* parent;
+};
+
+inline const LazyMemberInitFrame*& lazyMemberInitFrames()
+{
+    thread_local auto frames = static_cast<const LazyMemberInitFrame*>(nullptr);
+    return frames;
+}
+
+inline bool isLazyMemberInitializingOnThisThread(const void* member)
+{
+    for (auto frame = lazyMemberInitFrames(); frame; frame = frame->parent)
+        if (frame->member == member)
+            return true;
+    return false;
+}
+
+// Waiting threads block on a slot picked by the member's address, so the members don't have to store a mutex
+struct LazyMemberWaitSlot {
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+inline LazyMemberWaitSlot& lazyMemberWaitSlot(const void* member)
+{
+    static auto slots = std::array<LazyMemberWaitSlot, 32>{};
+    return slots[(reinterpret_cast<std::uintptr_t>(member) / alignof(std::max_align_t)) % slots.size()];
+}
+
+template<lazy_init Init>
+class LazyMemberStateFlag;
+
+template<>
+class LazyMemberStateFlag<lazy_init::thread_safe> {
+public:
+    class InitScope {
+    public:
+        explicit InitScope(const LazyMemberStateFlag& flag)
+            : frame_{&flag, lazyMemberInitFrames()}
+        {
+            lazyMemberInitFrames() = &frame_;
+        }
+
+        ~InitScope()
+        {
+            lazyMemberInitFrames() = frame_.parent;
+        }
+
+        InitScope(const InitScope&) = delete;
+        InitScope& operator=(const InitScope&) = delete;
+
+    private:
+        LazyMemberInitFrame frame_;
+    };
+
+    bool isInitialized() const
+    {
+        return state_.load(std::memory_order_acquire) == LazyMemberState::Initialized;
+    }
+
+    // Returns true if the caller has to initialize the value, otherwise waits for the concurrent initialization
+    bool beginInit()
+    {
+        auto spinCount = 0;
+        auto state = LazyMemberState::Empty;
+        while (!state_.compare_exchange_weak(
+                state,
+                LazyMemberState::Initializing,
+                std::memory_order_acquire,
+                std::memory_order_acquire)) {
+            if (state == LazyMemberState::Initialized)
+                return false;
+            if (state != LazyMemberState::Empty) {
+                // The factory accessing its own member would wait for itself forever
+                sfun_precondition(!isLazyMemberInitializingOnThisThread(this));
+                if (spinCount < maxSpinCount) {
+                    ++spinCount;
+                    std::this_thread::yield();
+                }
+                else
+                    wait();
+            }
+            state = LazyMemberState::Empty;
+        }
+        return true;
+    }
+
+    void endInit(bool success)
+    {
+        const auto prevState = state_.exchange(
+                success ? LazyMemberState::Initialized : LazyMemberState::Empty,
+                std::memory_order_acq_rel);
+        if (prevState == LazyMemberState::InitializingWithWaiters) {
+            auto& slot = lazyMemberWaitSlot(this);
+            auto lock = std::lock_guard{slot.mutex};
+            slot.condition.notify_all();
+        }
+    }
+
+    void reset()
+    {
+        state_.store(LazyMemberState::Empty, std::memory_order_relaxed);
+    }
+
+private:
+    // Marks the initialization as having waiters under the slot's mutex, so endInit() can't miss the waiting thread.
+    // Returns on any change of the state, including another initialization that hasn't been marked yet.
+    void wait()
+    {
+        auto& slot = lazyMemberWaitSlot(this);
+        auto lock = std::unique_lock{slot.mutex};
+        auto state = LazyMemberState::Initializing;
+        if (!state_.compare_exchange_strong(
+                    state,
+                    LazyMemberState::InitializingWithWaiters,
+                    std::memory_order_relaxed) &&
+            state != LazyMemberState::InitializingWithWaiters)
+            return;
+        slot.condition.wait(
+                lock,
+                [this]
+                {
+                    return state_.load(std::memory_order_relaxed) != LazyMemberState::InitializingWithWaiters;
+                });
+    }
+
+private:
+    static constexpr auto maxSpinCount = 64;
+    std::atomic<LazyMemberState> state_ = LazyMemberState::Empty;
+};
+
+template<>
+class LazyMemberStateFlag<lazy_init::single_threaded> {
+public:
+    struct InitScope {
+        explicit InitScope(const LazyMemberStateFlag&) {}
+    };
+
+    bool isInitialized() const
+    {
+        return state_ == LazyMemberState::Initialized;
+    }
+
+    bool beginInit()
+    {
+        // The factory accessing its own member would construct the value twice
+        sfun_precondition(state_ != LazyMemberState::Initializing);
+        state_ = LazyMemberState::Initializing;
+        return true;
+    }
+
+    void endInit(bool success)
+    {
+        state_ = success ? LazyMemberState::Initialized : LazyMemberState::Empty;
+    }
+
+    void reset()
+    {
+        state_ = LazyMemberState::Empty;
+    }
+
+private:
+    LazyMemberState state_ = LazyMemberState::Empty;
+};
+
+} //namespace detail
+
+///
+/// A member constructed from the result of Factory on the first access.
+/// After the initialization, access costs a single check of the state byte. With lazy_init::thread_safe
+/// the first access can happen concurrently: one thread calls the factory while the others wait for it.
+/// Threads waiting for a long initialization block instead of spinning. Accessing the member from its own factory
+/// is a precondition violation.
+/// If the factory throws, the member stays uninitialized and the next access calls it again.
+/// Provides the same comparison, bool conversion, subscript and call operators as sfun::member, applied to the value.
+///
+template<typename T, typename Factory, lazy_init Init = lazy_init::thread_safe>
+class lazy_member : private detail::MemberStorage<Factory> {
+    static_assert(!std::is_reference_v<T>, "sfun::lazy_member doesn't support references");
+    static_assert(!std::is_array_v<T>, "sfun::lazy_member doesn't support arrays");
+    static_assert(
+            std::is_convertible_v<std::invoke_result_t<const Factory&>, T>,
+            "lazy_member factory must be const-invocable and return a value convertible to T");
+
+public:
+    lazy_member() = default;
+
+    explicit lazy_member(Factory factory)
+        : detail::MemberStorage<Factory>{std::in_place, std::move(factory)}
+    {
+    }
+
+    // Copies and moves aren't synchronized with the first access of the source
+    lazy_member(const lazy_member& other)
+        : detail::MemberStorage<Factory>{other}
+    {
+        if (other.is_initialized())
+            emplace(*other.ptr());
+    }
+
+    lazy_member(lazy_member&& other) noexcept(
+            std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<Factory>)
+        : detail::MemberStorage<Factory>{std::move(other)}
+    {
+        if (other.is_initialized())
+            emplace(std::move(*other.ptr()));
+    }
+
+    lazy_member& operator=(const lazy_member& other)
+    {
+        if (this != &other) {
+            destroy();
+            detail::MemberStorage<Factory>::operator=(other);
+            if (other.is_initialized())
+                emplace(*other.ptr());
+        }
+        return *this;
+    }
+
+    lazy_member& operator=(lazy_member&& other) noexcept(
+            std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<Factory>)
+    {
+        if (this != &other) {
+            destroy();
+            detail::MemberStorage<Factory>::operator=(std::move(other));
+            if (other.is_initialized())
+                emplace(std::move(*other.ptr()));
+        }
+        return *this;
+    }
+
+    ~lazy_member()
+    {
+        destroy();
+    }
+
+    bool is_initialized() const
+    {
+        return state_.isInitialized();
+    }
+
+    /// Destroys the value, so the next access calls the factory again. Not synchronized with the concurrent access.
+    void reset()
+    {
+        destroy();
+    }
+
+    const T& get() const
+    {
+        if (!state_.isInitialized())
+            init();
+        return *ptr();
+    }
+
+    T& get()
+    {
+        if (!state_.isInitialized())
+            init();
+        return *ptr();
+    }
+
+    operator const T&() const
+    {
+        return get();
+    }
+
+    operator T&()
+    {
+        return get();
+    }
+
+    const T* operator->() const
+    {
+        return &get();
+    }
+
+    T* operator->()
+    {
+        return &get();
+    }
+
+    const T& operator*() const
+    {
+        return get();
+    }
+
+    T& operator*()
+    {
+        return get();
+    }
+
+    template<typename CheckType = T, std::enable_if_t<std::is_constructible_v<bool, CheckType>>* = nullptr>
+    explicit operator bool() const
+    {
+        return static_cast<bool>(get());
+    }
+
+    template<
+            typename CheckType = T,
+            std::enable_if_t<provides_array_element_access_v<CheckType> || std::is_pointer_v<CheckType>>* = nullptr>
+    auto& operator[](std::size_t index)
+    {
+        return get()[index];
+    }
+
+    template<
+            typename CheckType = T,
+            std::enable_if_t<provides_array_element_access_v<CheckType> || std::is_pointer_v<CheckType>>* = nullptr>
+    const auto& operator[](std::size_t index) const
+    {
+        return get()[index];
+    }
+
+    template<
+            typename... TArgs,
+            typename CheckType = T,
+            std::enable_if_t<std::is_invocable_v<CheckType, TArgs...>>* = nullptr>
+    decltype(auto) operator()(TArgs&&... args) const
+    {
+        return get()(std::forward<TArgs>(args)...);
+    }
+
+    template<typename V>
+    bool operator==(const V& other) const
+    {
+        return get() == other;
+    }
+
+    template<typename V>
+    bool operator!=(const V& other) const
+    {
+        return get() != other;
+    }
+
+    template<typename V>
+    bool operator<=(const V& other) const
+    {
+        return get() <= other;
+    }
+
+    template<typename V>
+    bool operator<(const V& other) const
+    {
+        return get() < other;
+    }
+
+    template<typename V>
+    bool operator>=(const V& other) const
+    {
+        return get() >= other;
+    }
+
+    template<typename V>
+    bool operator>(const V& other) const
+    {
+        return get() > other;
+    }
+
+private:
+    T* ptr() const
+    {
+        return std::launder(reinterpret_cast<T*>(storage_));
+    }
+
+    template<typename... TArgs>
+    void emplace(TArgs&&... args)
+    {
+        new (storage_) T(std::forward<TArgs>(args)...);
+        state_.endInit(true);
+    }
+
+    void destroy()
+    {
+        if (state_.isInitialized()) {
+            ptr()->~T();
+            state_.reset();
+        }
+    }
+
+    void init() const
+    {
+        if (!state_.beginInit())
+            return;
+        [[maybe_unused]] auto scope = typename detail::LazyMemberStateFlag<Init>::InitScope{state_};
+        try {
+            new (storage_) T(this->storedValue()());
+        }
+        catch (...) {
+            state_.endInit(false);
+            throw;
+        }
+        state_.endInit(true);
+    }
+
+private:
+    alignas(T) mutable unsigned char storage_[sizeof(T)];
+    mutable detail::LazyMemberStateFlag<Init> state_;
+};
+
+} //namespace sfun
+
+#endif //SFUN_LAZY_MEMBER_H
@@ -3,14 +3,30 @@
 
 #include "contract.h"
 #include "type_traits.h"
+#include <cstddef>
 #include <memory>
 #include <type_traits>
 #include <utility>
 
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(msvc::no_unique_address)
+#define _sfun_no_unique_address [[msvc::no_unique_address]]
+#elif __has_cpp_attribute(no_unique_address)
+#define _sfun_no_unique_address [[__no_unique_address__]]
+#endif
+#endif
+#ifndef _sfun_no_unique_address
+#define _sfun_no_unique_address
+#endif
+
 namespace sfun {
 
 namespace detail {
 
+// std::hardware_destructive_interference_size depends on the tuning flags, so using it would make the layout of
+// cache_aligned differ between translation units
+inline constexpr auto destructiveInterferenceSize = std::size_t{64};
+
 template<typename T, typename V, std::enable_if_t<std::is_reference_v<T>>* = nullptr>
 inline constexpr auto memberInit(V& val)
 {
@@ -23,10 +39,78 @@ inline constexpr decltype(auto) memberInit(V&& val)
     return std::forward<V>(val);
 }
 
+template<typename T>
+inline constexpr auto isCompressedMember = !std::is_reference_v<T> && std::is_empty_v<T> && !std::is_final_v<T>;
+
+template<typename T, bool IsCompressed = isCompressedMember<T>>
+class MemberStorage {
+    using value_type = std::conditional_t< //
+            std::is_reference_v<T>,
+            std::remove_reference_t<std::remove_const_t<T>>*,
+            std::remove_const_t<T>>;
+
+public:
+    MemberStorage() = default;
+
+    template<typename V>
+    constexpr MemberStorage(std::in_place_t, V&& val)
+        : value_{std::forward<V>(val)}
+    {
+    }
+
+protected:
+    constexpr value_type& storedValue()
+    {
+        return value_;
+    }
+
+    constexpr const value_type& storedValue() const
+    {
+        return value_;
+    }
+
+private:
+    value_type value_{};
+};
+
+// Stateless types are stored as a data member that takes no space. Deriving from them instead would prevent member
+// from binding to const T&, as conversion functions are never used for conversions to a base class
+template<typename T>
+class MemberStorage<T, true> {
+    using value_type = std::remove_const_t<T>;
+
+public:
+    MemberStorage() = default;
+
+    template<typename V>
+    constexpr MemberStorage(std::in_place_t, V&& val)
+        : value_(std::forward<V>(val))
+    {
+    }
+
+protected:
+    constexpr value_type& storedValue()
+    {
+        return value_;
+    }
+
+    constexpr const value_type& storedValue() const
+    {
+        return value_;
+    }
+
+private:
+    _sfun_no_unique_address value_type value_{};
+};
+
 } //namespace detail
 
+///
+/// When T is an empty non-final class, it's stored with [[no_unique_address]],
+/// so member<T> stays empty and can benefit from the empty base optimization.
+///
 template<typename T>
-struct member {
+struct member : detail::MemberStorage<T> {
     static_assert(!std::is_array_v<T>, "sfun::member doesn't support arrays");
 
     template<typename TCheck = T, std::enable_if_t<!std::is_reference_v<TCheck>>* = nullptr>
@@ -39,40 +123,40 @@ struct member {
             typename TCheck = T,
             std::enable_if_t<!std::is_same_v<member<TCheck>, std::decay_t<V>>>* = nullptr>
     constexpr member(V&& val)
-        : value_{detail::memberInit<T>(std::forward<V>(val))}
+        : detail::MemberStorage<T>{std::in_place, detail::memberInit<T>(std::forward<V>(val))}
     {
     }
 
     constexpr std::conditional_t<std::is_reference_v<T>, T&, const T&> get() const
     {
         if constexpr (std::is_reference_v<T>)
-            return *value_;
+            return *this->storedValue();
         else
-            return value_;
+            return this->storedValue();
     }
 
     constexpr T& get()
     {
         if constexpr (std::is_reference_v<T>)
-            return *value_;
+            return *this->storedValue();
         else
-            return value_;
+            return this->storedValue();
     }
 
     constexpr operator std::conditional_t<std::is_reference_v<T>, T&, const T&>() const
     {
         if constexpr (std::is_reference_v<T>)
-            return *value_;
+            return *this->storedValue();
         else
-            return value_;
+            return this->storedValue();
     }
 
     constexpr operator T&()
     {
         if constexpr (std::is_reference_v<T>)
-            return *value_;
+            return *this->storedValue();
         else
-            return value_;
+            return this->storedValue();
     }
 
     template<typename V, std::enable_if_t<!std::is_same_v<V, member<T>>>* = nullptr>
@@ -100,13 +184,13 @@ struct member {
             std::enable_if_t<provides_member_access_v<CheckType> || std::is_pointer_v<CheckType>>* = nullptr>
     constexpr auto& operator->() const
     {
-        return value_;
+        return this->storedValue();
     }
 
     template<typename CheckType = T, std::enable_if_t<is_dereferencable_v<CheckType>>* = nullptr>
     constexpr auto& operator*() const
     {
-        return *value_;
+        return *this->storedValue();
     }
 
     template<
@@ -169,13 +253,16 @@ struct member {
     {
         return get() > other;
     }
+};
 
-private:
-    std::conditional_t< //
-            std::is_reference_v<T>,
-            std::remove_reference_t<std::remove_const_t<T>>*,
-            std::remove_const_t<T>>
-            value_{};
+///
+/// A member aligned and padded to 64 bytes, the cache line size of common architectures,
+/// so values modified by different threads don't share a cache line.
+///
+template<typename T>
+struct alignas(detail::destructiveInterferenceSize) cache_aligned : member<T> {
+    using member<T>::member;
+    using member<T>::operator=;
 };
 
 template<typename T>
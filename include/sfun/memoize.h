@@ -0,0 +1,485 @@
+#ifndef SFUN_MEMOIZE_H
+#define SFUN_MEMOIZE_H
+
+#include "detail/thread_stripes.h"
+#include "functional.h"
+#include "type_list.h"
+#include "type_traits.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sfun {
+
+struct memoize_options {
+    /// Maximum number of cached results, 0 means unbounded. Bounded caches evict entries with the CLOCK algorithm.
+    std::size_t capacity = 0;
+    /// Number of independently locked shards, reduced to capacity for smaller bounded caches
+    std::size_t shard_count = 16;
+};
+
+struct memoize_stats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+};
+
+namespace detail {
+
+struct MemoizeKeyHash {
+    template<typename... Ts>
+    std::size_t operator()(const std::tuple<Ts...>& key) const
+    {
+        auto result = std::size_t{};
+        std::apply(
+                [&result](const auto&... values)
+                {
+                    ((result ^= std::hash<std::decay_t<decltype(values)>>{}(values) + 0x9e3779b9 + (result << 6) +
+                             (result >> 2)),
+                     ...);
+                },
+                key);
+        return result;
+    }
+};
+
+} //namespace detail
+
+namespace detail {
+
+// Intrusive FIFO of objects waiting for deletion, each one is tagged with the epoch it was retired at
+template<typename T>
+class MemoizeRetiredList {
+public:
+    MemoizeRetiredList() = default;
+    MemoizeRetiredList(const MemoizeRetiredList&) = delete;
+    MemoizeRetiredList& operator=(const MemoizeRetiredList&) = delete;
+    MemoizeRetiredList(MemoizeRetiredList&& other) noexcept
+        : head_{std::exchange(other.head_, nullptr)}
+        , tail_{std::exchange(other.tail_, nullptr)}
+    {
+    }
+    MemoizeRetiredList& operator=(MemoizeRetiredList&& other) noexcept
+    {
+        if (this != &other) {
+            deleteAll();
+            head_ = std::exchange(other.head_, nullptr);
+            tail_ = std::exchange(other.tail_, nullptr);
+        }
+        return *this;
+    }
+    ~MemoizeRetiredList()
+    {
+        deleteAll();
+    }
+
+    bool empty() const
+    {
+        return head_ == nullptr;
+    }
+
+    void push(T* item)
+    {
+        item->nextRetired = nullptr;
+        if (tail_)
+            tail_->nextRetired = item;
+        else
+            head_ = item;
+        tail_ = item;
+    }
+
+    void splice(MemoizeRetiredList&& other, std::size_t epoch)
+    {
+        for (auto* item = other.head_; item; item = item->nextRetired)
+            item->retireEpoch = epoch;
+        if (!other.head_)
+            return;
+        if (tail_)
+            tail_->nextRetired = other.head_;
+        else
+            head_ = other.head_;
+        tail_ = other.tail_;
+        other.head_ = nullptr;
+        other.tail_ = nullptr;
+    }
+
+    MemoizeRetiredList takeRetiredBefore(std::size_t epoch)
+    {
+        auto result = MemoizeRetiredList{};
+        while (head_ && epoch - head_->retireEpoch >= 2) {
+            auto* item = head_;
+            head_ = item->nextRetired;
+            result.push(item);
+        }
+        if (!head_)
+            tail_ = nullptr;
+        return result;
+    }
+
+private:
+    void deleteAll()
+    {
+        while (head_)
+            delete std::exchange(head_, head_->nextRetired);
+        tail_ = nullptr;
+    }
+
+private:
+    T* head_ = nullptr;
+    T* tail_ = nullptr;
+};
+
+} //namespace detail
+
+///
+/// A thread-safe wrapper caching results of a pure callable, created with sfun::memoize.
+/// Cached results are stored in hash tables split into shards. Lookups don't take locks or write to shared memory:
+/// the nodes of a shard are linked with atomic pointers, and only insertions take the shard's mutex.
+/// Removed nodes and replaced bucket arrays are deleted by later insertions, once all lookups that could have read
+/// them are finished. Lookups are counted for that in per-thread stripes, next to the hit and miss counters.
+///
+template<typename F>
+class memoized_function {
+public:
+    using key_type = decay_tuple_t<to_tuple_t<callable_args<F>>>;
+    using result_type = std::decay_t<callable_return_type<F>>;
+
+private:
+    struct Node {
+        template<typename TResult>
+        Node(key_type&& key, TResult&& value, std::size_t hash)
+            : key{std::move(key)}
+            , result{std::forward<TResult>(value)}
+            , hash{hash}
+        {
+        }
+
+        key_type key;
+        result_type result;
+        std::size_t hash;
+        std::atomic<Node*> next = nullptr;
+        mutable std::atomic<bool> referenced = false;
+        Node* nextRetired = nullptr;
+        std::size_t retireEpoch = 0;
+    };
+
+    struct Buckets {
+        explicit Buckets(std::size_t count)
+            : count{count}
+            , heads{std::make_unique<std::atomic<Node*>[]>(count)}
+        {
+        }
+
+        std::size_t count;
+        std::unique_ptr<std::atomic<Node*>[]> heads;
+        Buckets* nextRetired = nullptr;
+        std::size_t retireEpoch = 0;
+    };
+
+    static constexpr auto initialBucketCount = std::size_t{16};
+
+    struct alignas(64) Shard {
+        ~Shard()
+        {
+            auto* shardBuckets = buckets.load(std::memory_order_relaxed);
+            if (!shardBuckets)
+                return;
+            for (auto i = std::size_t{}; i < shardBuckets->count; ++i)
+                for (auto* node = shardBuckets->heads[i].load(std::memory_order_relaxed); node;)
+                    delete std::exchange(node, node->next.load(std::memory_order_relaxed));
+            delete shardBuckets;
+        }
+
+        std::mutex mutex;
+        std::atomic<Buckets*> buckets = nullptr;
+        std::atomic<std::size_t> size = 0;
+        // CLOCK ring of cached nodes, it's only used under the mutex
+        std::vector<Node*> clock;
+        std::size_t clockHand = 0;
+        std::size_t capacity = 0;
+    };
+
+    // Lookups are counted separately for odd and even epochs, so the counter of the previous epoch drains
+    // while new lookups keep starting.
+    struct alignas(64) ReaderStripe {
+        std::atomic<std::size_t> activeLookupCount[2] = {};
+        std::atomic<std::size_t> hits = 0;
+        std::atomic<std::size_t> misses = 0;
+    };
+
+    struct Reclamation {
+        std::mutex mutex;
+        std::atomic<std::size_t> epoch = 0;
+        detail::MemoizeRetiredList<Node> nodes;
+        detail::MemoizeRetiredList<Buckets> buckets;
+    };
+
+    class LookupGuard {
+    public:
+        LookupGuard(ReaderStripe& stripe, const std::atomic<std::size_t>& epoch)
+            : stripe_{stripe}
+            , parity_{epoch.load(std::memory_order_relaxed) % 2}
+        {
+            stripe_.activeLookupCount[parity_].fetch_add(1, std::memory_order_seq_cst);
+        }
+        ~LookupGuard()
+        {
+            stripe_.activeLookupCount[parity_].fetch_sub(1, std::memory_order_release);
+        }
+        LookupGuard(const LookupGuard&) = delete;
+        LookupGuard& operator=(const LookupGuard&) = delete;
+
+    private:
+        ReaderStripe& stripe_;
+        std::size_t parity_;
+    };
+
+public:
+    explicit memoized_function(F f, const memoize_options& options = {})
+        : f_{std::move(f)}
+        , shardCount_{shardCount(options)}
+        , shards_{std::make_unique<Shard[]>(shardCount_)}
+        , stripeCount_{detail::threadStripeCount()}
+        , stripes_{std::make_unique<ReaderStripe[]>(stripeCount_)}
+        , reclamation_{std::make_unique<Reclamation>()}
+    {
+        // The capacity is split between the shards, so their total doesn't exceed it
+        for (auto i = std::size_t{}; i < shardCount_; ++i) {
+            shards_[i].capacity = options.capacity / shardCount_ + (i < options.capacity % shardCount_ ? 1 : 0);
+            shards_[i].clock.reserve(shards_[i].capacity);
+        }
+    }
+
+    template<typename... TArgs>
+    result_type operator()(TArgs&&... args) const
+    {
+        auto key = key_type{std::forward<TArgs>(args)...};
+        const auto hash = detail::MemoizeKeyHash{}(key);
+        auto& shard = shards_[hash % shardCount_];
+        auto& stripe = stripes_[detail::threadStripeIndex() % stripeCount_];
+        {
+            auto guard = LookupGuard{stripe, reclamation_->epoch};
+            const auto* buckets = shard.buckets.load(std::memory_order_seq_cst);
+            if (const auto* node = find(buckets, key, hash, std::memory_order_seq_cst)) {
+                if (!node->referenced.load(std::memory_order_relaxed))
+                    node->referenced.store(true, std::memory_order_relaxed);
+                stripe.hits.fetch_add(1, std::memory_order_relaxed);
+                return node->result;
+            }
+        }
+        stripe.misses.fetch_add(1, std::memory_order_relaxed);
+
+        // The callable is pure, so concurrent misses of the same key can compute it without holding the lock.
+        auto result = std::apply(f_, std::as_const(key));
+        auto retiredNodes = detail::MemoizeRetiredList<Node>{};
+        auto* retiredBuckets = static_cast<Buckets*>(nullptr);
+        {
+            auto lock = std::lock_guard{shard.mutex};
+            if (!find(shard.buckets.load(std::memory_order_relaxed), key, hash, std::memory_order_relaxed))
+                insert(shard, std::move(key), result, hash, retiredNodes, retiredBuckets);
+        }
+        retire(std::move(retiredNodes), retiredBuckets);
+        return result;
+    }
+
+    memoize_stats stats() const
+    {
+        auto result = memoize_stats{};
+        for (auto i = std::size_t{}; i < stripeCount_; ++i) {
+            result.hits += stripes_[i].hits.load(std::memory_order_relaxed);
+            result.misses += stripes_[i].misses.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    std::size_t size() const
+    {
+        auto result = std::size_t{};
+        for (auto i = std::size_t{}; i < shardCount_; ++i)
+            result += shards_[i].size.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void clear()
+    {
+        for (auto i = std::size_t{}; i < shardCount_; ++i) {
+            auto& shard = shards_[i];
+            auto retiredNodes = detail::MemoizeRetiredList<Node>{};
+            {
+                auto lock = std::lock_guard{shard.mutex};
+                auto* buckets = shard.buckets.load(std::memory_order_relaxed);
+                if (!buckets)
+                    continue;
+                for (auto j = std::size_t{}; j < buckets->count; ++j) {
+                    auto* node = buckets->heads[j].exchange(nullptr, std::memory_order_seq_cst);
+                    while (node) {
+                        auto* next = node->next.load(std::memory_order_relaxed);
+                        retiredNodes.push(node);
+                        node = next;
+                    }
+                }
+                shard.clock.clear();
+                shard.clockHand = 0;
+                shard.size.store(0, std::memory_order_relaxed);
+            }
+            retire(std::move(retiredNodes), nullptr);
+        }
+    }
+
+private:
+    static std::size_t shardCount(const memoize_options& options)
+    {
+        auto result = options.shard_count > 0 ? options.shard_count : std::size_t{1};
+        if (options.capacity > 0 && options.capacity < result)
+            result = options.capacity;
+        return result;
+    }
+
+    // The low bits of the hash select the shard, so the bucket is selected by the remaining ones
+    std::size_t bucketIndex(const Buckets& buckets, std::size_t hash) const
+    {
+        return (hash / shardCount_) % buckets.count;
+    }
+
+    const Node* find(const Buckets* buckets, const key_type& key, std::size_t hash, std::memory_order order) const
+    {
+        if (!buckets)
+            return nullptr;
+        for (auto* node = buckets->heads[bucketIndex(*buckets, hash)].load(order); node; node = node->next.load(order))
+            if (node->hash == hash && node->key == key)
+                return node;
+        return nullptr;
+    }
+
+    // Must be called under the shard's mutex. Everything that can throw is done before the shard is modified.
+    void insert(
+            Shard& shard,
+            key_type&& key,
+            const result_type& result,
+            std::size_t hash,
+            detail::MemoizeRetiredList<Node>& retiredNodes,
+            Buckets*& retiredBuckets) const
+    {
+        auto node = std::make_unique<Node>(std::move(key), result, hash);
+        auto* buckets = shard.buckets.load(std::memory_order_relaxed);
+        const auto isEvicting = shard.capacity != 0 && shard.clock.size() == shard.capacity;
+        const auto newSize = shard.size.load(std::memory_order_relaxed) + (isEvicting ? 0 : 1);
+        auto newBuckets = std::unique_ptr<Buckets>{};
+        if (!buckets)
+            newBuckets = std::make_unique<Buckets>(initialBucketCount);
+        else if (newSize > buckets->count)
+            newBuckets = std::make_unique<Buckets>(buckets->count * 2);
+
+        if (isEvicting)
+            retiredNodes.push(evict(shard, *buckets, node.get()));
+        else if (shard.capacity != 0)
+            shard.clock.push_back(node.get());
+
+        if (newBuckets) {
+            if (buckets)
+                rehash(*buckets, *newBuckets);
+            retiredBuckets = buckets;
+            buckets = newBuckets.release();
+            shard.buckets.store(buckets, std::memory_order_seq_cst);
+        }
+
+        auto& head = buckets->heads[bucketIndex(*buckets, hash)];
+        node->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        head.store(node.release(), std::memory_order_release);
+        shard.size.store(newSize, std::memory_order_relaxed);
+    }
+
+    // Nodes referenced since the last pass get a second chance, the first unreferenced one is unlinked
+    // and replaced with the new node in the CLOCK ring.
+    Node* evict(Shard& shard, Buckets& buckets, Node* replacement) const
+    {
+        while (true) {
+            auto& victim = shard.clock[shard.clockHand];
+            shard.clockHand = (shard.clockHand + 1) % shard.capacity;
+            if (victim->referenced.load(std::memory_order_relaxed)) {
+                victim->referenced.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            auto* link = &buckets.heads[bucketIndex(buckets, victim->hash)];
+            while (link->load(std::memory_order_relaxed) != victim)
+                link = &link->load(std::memory_order_relaxed)->next;
+            link->store(victim->next.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+            return std::exchange(victim, replacement);
+        }
+    }
+
+    // Lookups in the old buckets can follow the relinked nodes into the chains of the new ones. The moved nodes only
+    // link to the already moved ones, so the chains stay acyclic and such lookups end with a false miss at worst.
+    void rehash(Buckets& buckets, Buckets& newBuckets) const
+    {
+        for (auto i = std::size_t{}; i < buckets.count; ++i) {
+            for (auto* node = buckets.heads[i].load(std::memory_order_relaxed); node;) {
+                auto* next = node->next.load(std::memory_order_relaxed);
+                auto& head = newBuckets.heads[bucketIndex(newBuckets, node->hash)];
+                node->next.store(head.load(std::memory_order_relaxed), std::memory_order_release);
+                head.store(node, std::memory_order_relaxed);
+                node = next;
+            }
+        }
+    }
+
+    bool hasActiveLookups(std::size_t parity) const
+    {
+        for (auto i = std::size_t{}; i < stripeCount_; ++i)
+            if (stripes_[i].activeLookupCount[parity].load(std::memory_order_seq_cst) != 0)
+                return true;
+        return false;
+    }
+
+    // A lookup that could have reached an object retired at epoch N had started before the object was unlinked,
+    // so it's counted under the parity of N or N - 1, or of an even older epoch. Advancing the epoch to N + 1
+    // and then to N + 2 requires both counters to drain after the unlinking, so the object can be deleted then.
+    // The deleted objects are destroyed outside the mutex.
+    void retire(detail::MemoizeRetiredList<Node>&& nodes, Buckets* buckets) const
+    {
+        auto reclaimedNodes = detail::MemoizeRetiredList<Node>{};
+        auto reclaimedBuckets = detail::MemoizeRetiredList<Buckets>{};
+        auto& reclamation = *reclamation_;
+        auto lock = std::lock_guard{reclamation.mutex};
+        reclamation.nodes.splice(std::move(nodes), reclamation.epoch.load(std::memory_order_relaxed));
+        if (buckets) {
+            buckets->retireEpoch = reclamation.epoch.load(std::memory_order_relaxed);
+            reclamation.buckets.push(buckets);
+        }
+
+        for (auto step = 0; step < 2 && !(reclamation.nodes.empty() && reclamation.buckets.empty()); ++step) {
+            const auto epoch = reclamation.epoch.load(std::memory_order_relaxed);
+            if (hasActiveLookups((epoch + 1) % 2))
+                break;
+            reclamation.epoch.store(epoch + 1, std::memory_order_seq_cst);
+        }
+        const auto epoch = reclamation.epoch.load(std::memory_order_relaxed);
+        reclaimedNodes = reclamation.nodes.takeRetiredBefore(epoch);
+        reclaimedBuckets = reclamation.buckets.takeRetiredBefore(epoch);
+    }
+
+private:
+    F f_;
+    std::size_t shardCount_;
+    std::unique_ptr<Shard[]> shards_;
+    std::size_t stripeCount_;
+    std::unique_ptr<ReaderStripe[]> stripes_;
+    std::unique_ptr<Reclamation> reclamation_;
+};
+
+/// Wraps a pure callable with non-overloaded operator() in a thread-safe cache of its results.
+/// Arguments are stored as keys in their decayed form and must be hashable with std::hash.
+template<typename F>
+auto memoize(F&& f, const memoize_options& options = {})
+{
+    return memoized_function<std::decay_t<F>>{std::forward<F>(f), options};
+}
+
+} //namespace sfun
+
+#endif //SFUN_MEMOIZE_H
@@ -0,0 +1,188 @@
+#ifndef SFUN_PACKED_TUPLE_H
+#define SFUN_PACKED_TUPLE_H
+
+#include "type_list.h"
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace sfun {
+
+template<typename... Ts>
+class packed_tuple;
+
+namespace detail {
+
+template<std::size_t N>
+struct PackedTupleLayout {
+    // order[storage position] == element index
+    std::array<std::size_t, N> order{};
+    // position[element index] == storage position
+    std::array<std::size_t, N> position{};
+};
+
+// Stable insertion sort by descending alignment: as sizes are multiples of alignments,
+// no padding is needed between the elements, only at the end of the storage.
+template<std::size_t N>
+constexpr auto makePackedTupleLayout(const std::array<std::size_t, N>& alignments)
+{
+    auto layout = PackedTupleLayout<N>{};
+    for (auto i = std::size_t{}; i < N; ++i) {
+        auto j = i;
+        for (; j > 0 && alignments[layout.order[j - 1]] < alignments[i]; --j)
+            layout.order[j] = layout.order[j - 1];
+        layout.order[j] = i;
+    }
+    for (auto i = std::size_t{}; i < N; ++i)
+        layout.position[layout.order[i]] = i;
+    return layout;
+}
+
+template<std::size_t I, typename T>
+struct PackedTupleLeaf {
+    PackedTupleLeaf() = default;
+
+    template<typename TArg>
+    constexpr PackedTupleLeaf(std::in_place_t, TArg&& arg)
+        : value(std::forward<TArg>(arg))
+    {
+    }
+
+    T value{};
+};
+
+template<typename TIndexSequence, typename... Ts>
+struct PackedTupleStorage;
+
+// Base subobjects are laid out in declaration order by the Itanium and MSVC ABIs,
+// so the leaves end up in memory sorted by the layout.
+template<std::size_t... I, typename... Ts>
+struct PackedTupleStorage<std::index_sequence<I...>, Ts...> : PackedTupleLeaf<I, Ts>... {
+    PackedTupleStorage() = default;
+
+    template<typename TArgs>
+    constexpr PackedTupleStorage(std::in_place_t, TArgs&& args)
+        : PackedTupleLeaf<I, Ts>{std::in_place, std::get<I>(std::forward<TArgs>(args))}...
+    {
+    }
+};
+
+template<typename... Ts>
+struct PackedTupleTraits {
+    static constexpr auto layout = makePackedTupleLayout(std::array<std::size_t, sizeof...(Ts)>{alignof(Ts)...});
+
+    template<std::size_t... I>
+    static auto makeStorage(std::index_sequence<I...>) -> PackedTupleStorage<
+            std::index_sequence<I...>,
+            typename decltype(type_list<Ts...>::template at<layout.order[I]>())::type...>;
+
+    using storage = decltype(makeStorage(std::index_sequence_for<Ts...>{}));
+
+    // Reorders forwarded constructor arguments to the storage order
+    template<typename TArgs, std::size_t... I>
+    static constexpr auto sortArgs(TArgs&& args, std::index_sequence<I...>)
+    {
+        return std::forward_as_tuple(std::get<layout.order[I]>(std::forward<TArgs>(args))...);
+    }
+};
+
+} //namespace detail
+
+///
+/// A tuple which stores its elements sorted by alignment to minimize padding,
+/// elements are still accessed by their declaration index with sfun::get<I>
+///
+template<typename... Ts>
+class packed_tuple {
+    using traits = detail::PackedTupleTraits<Ts...>;
+
+public:
+    packed_tuple() = default;
+
+    template<
+            typename... TArgs,
+            std::enable_if_t<
+                    sizeof...(TArgs) == sizeof...(Ts) && sizeof...(TArgs) != 0 &&
+                    (sizeof...(TArgs) != 1 || !(std::is_same_v<std::decay_t<TArgs>, packed_tuple> || ...))>* = nullptr>
+    constexpr packed_tuple(TArgs&&... args)
+        : storage_{
+                  std::in_place,
+                  traits::sortArgs(std::forward_as_tuple(std::forward<TArgs>(args)...), std::index_sequence_for<Ts...>{})}
+    {
+    }
+
+    static constexpr std::size_t size()
+    {
+        return sizeof...(Ts);
+    }
+
+    template<std::size_t I>
+    static constexpr std::size_t storage_position()
+    {
+        static_assert(I < sizeof...(Ts), "packed_tuple index is out of range");
+        return traits::layout.position[I];
+    }
+
+private:
+    template<std::size_t I>
+    using element_type = typename decltype(type_list<Ts...>::template at<I>())::type;
+
+    template<std::size_t I>
+    constexpr element_type<I>& leafValue() &
+    {
+        return static_cast<detail::PackedTupleLeaf<storage_position<I>(), element_type<I>>&>(storage_).value;
+    }
+
+    template<std::size_t I>
+    constexpr const element_type<I>& leafValue() const&
+    {
+        return static_cast<const detail::PackedTupleLeaf<storage_position<I>(), element_type<I>>&>(storage_).value;
+    }
+
+    template<std::size_t I, typename... TArgs>
+    friend constexpr auto& get(packed_tuple<TArgs...>& tuple);
+    template<std::size_t I, typename... TArgs>
+    friend constexpr const auto& get(const packed_tuple<TArgs...>& tuple);
+    template<std::size_t I, typename... TArgs>
+    friend constexpr auto&& get(packed_tuple<TArgs...>&& tuple);
+
+private:
+    typename traits::storage storage_;
+};
+
+template<std::size_t I, typename... Ts>
+constexpr auto& get(packed_tuple<Ts...>& tuple)
+{
+    return tuple.template leafValue<I>();
+}
+
+template<std::size_t I, typename... Ts>
+constexpr const auto& get(const packed_tuple<Ts...>& tuple)
+{
+    return tuple.template leafValue<I>();
+}
+
+template<std::size_t I, typename... Ts>
+constexpr auto&& get(packed_tuple<Ts...>&& tuple)
+{
+    using T = typename decltype(type_list<Ts...>::template at<I>())::type;
+    return static_cast<T&&>(tuple.template leafValue<I>());
+}
+
+} //namespace sfun
+
+namespace std {
+
+template<typename... Ts>
+struct tuple_size<sfun::packed_tuple<Ts...>> : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template<std::size_t I, typename... Ts>
+struct tuple_element<I, sfun::packed_tuple<Ts...>> {
+    using type = typename decltype(sfun::type_list<Ts...>::template at<I>())::type;
+};
+
+} //namespace std
+
+#endif //SFUN_PACKED_TUPLE_H
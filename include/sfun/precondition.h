@@ -2,10 +2,13 @@
 #define SFUN_PRECONDITION_H
 
 #include "contract.h"
+#include "span.h"
 #include "utility.h"
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <type_traits>
+#include <utility>
 
 namespace sfun {
 
@@ -72,22 +75,54 @@ enum class interval_type {
     open
 };
 
-template<interval_type intervalType, typename T, T min, T max>
+// Checks that the bound keeps its value and sign when it's converted to T
+template<typename T, auto bound>
+constexpr bool isRepresentableBound()
+{
+    using TBound = decltype(bound);
+    constexpr auto converted = static_cast<T>(bound);
+    return static_cast<TBound>(converted) == bound && (bound < TBound{}) == (converted < T{});
+}
+
+// Bounds are converted to T, so floating point intervals can be used with integral bounds
+// (C++17 doesn't support floating point template parameters)
+template<interval_type intervalType, typename T, auto min, auto max>
 struct check_interval {
-    static_assert(std::is_integral_v<T>);
+    static_assert(std::is_arithmetic_v<T>);
+    static_assert(std::is_arithmetic_v<decltype(min)> && std::is_arithmetic_v<decltype(max)>);
+    static_assert(isRepresentableBound<T, min>(), "The interval's lower bound isn't representable by its value type");
+    static_assert(isRepresentableBound<T, max>(), "The interval's upper bound isn't representable by its value type");
+
+    static constexpr auto lowerBound = static_cast<T>(min);
+    static constexpr auto upperBound = static_cast<T>(max);
+    static constexpr auto isLowerBoundIncluded = intervalType != interval_type::open;
+    static constexpr auto isUpperBoundIncluded = intervalType == interval_type::closed;
+
+    // Evaluates both comparisons without branching, so batch checks can be vectorized; NaN doesn't satisfy it
+    static constexpr bool isSatisfied(const T& x)
+    {
+        return (isLowerBoundIncluded ? x >= lowerBound : x > lowerBound) &
+                (isUpperBoundIncluded ? x <= upperBound : x < upperBound);
+    }
 
     constexpr void operator()(T& x) const
     {
         if constexpr (intervalType == interval_type::closed)
-            sfun_precondition(x >= min && x <= max);
+            sfun_precondition(x >= lowerBound && x <= upperBound);
         if constexpr (intervalType == interval_type::half_open)
-            sfun_precondition(x >= min && x < max);
+            sfun_precondition(x >= lowerBound && x < upperBound);
         if constexpr (intervalType == interval_type::open)
-            sfun_precondition(x > min && x < max);
+            sfun_precondition(x > lowerBound && x < upperBound);
     }
 };
 
 struct check_not_negative {
+    template<typename T>
+    static constexpr bool isSatisfied(const T& x)
+    {
+        return x >= T{0};
+    }
+
     template<typename T>
     constexpr void operator()(T& x) const
     {
@@ -95,6 +130,40 @@ struct check_not_negative {
     }
 };
 
+// The elements are checked in fixed-size blocks: within a block the results are summed without branching,
+// so the loop can be vectorized, and a violation is detected at the end of the block.
+template<typename TElementCheck, typename T>
+constexpr std::size_t countSatisfying(const T* data, std::size_t size)
+{
+    auto result = std::size_t{};
+    for (auto i = std::size_t{}; i < size; ++i)
+        result += TElementCheck::isSatisfied(data[i]) ? 1 : 0;
+    return result;
+}
+
+template<typename TElementCheck, typename T>
+constexpr bool allSatisfy(span<T> values)
+{
+    constexpr auto blockSize = std::size_t{256};
+    const auto data = values.data();
+    const auto size = values.size();
+    auto blockBegin = std::size_t{};
+    for (; blockBegin + blockSize <= size; blockBegin += blockSize)
+        if (countSatisfying<TElementCheck>(data + blockBegin, blockSize) != blockSize)
+            return false;
+    return countSatisfying<TElementCheck>(data + blockBegin, size - blockBegin) == size - blockBegin;
+}
+
+// Checks that all elements of a span satisfy TElementCheck
+template<typename TElementCheck>
+struct check_all {
+    template<typename T>
+    constexpr void operator()(span<T>& values) const
+    {
+        sfun_precondition(allSatisfy<TElementCheck>(values));
+    }
+};
+
 } //namespace detail
 
 template<typename T>
@@ -103,18 +172,245 @@ using not_empty = arg_precondition<detail::check_not_empty, T>;
 template<typename T>
 using valid = arg_precondition<detail::check_valid, T>;
 
-template<typename T, T min, T max>
+template<typename T, auto min, auto max>
 using interval = arg_precondition<detail::check_interval<detail::interval_type::half_open, T, min, max>, T>;
 
-template<typename T, T min, T max>
+template<typename T, auto min, auto max>
 using interval_closed = arg_precondition<detail::check_interval<detail::interval_type::closed, T, min, max>, T>;
 
-template<typename T, T min, T max>
+template<typename T, auto min, auto max>
 using interval_open = arg_precondition<detail::check_interval<detail::interval_type::open, T, min, max>, T>;
 
 template<typename T>
 using not_negative = arg_precondition<detail::check_not_negative, T>;
 
+template<typename T, auto min, auto max>
+constexpr bool all_in_interval(span<const T> values)
+{
+    return detail::allSatisfy<detail::check_interval<detail::interval_type::half_open, T, min, max>>(values);
+}
+
+template<typename T, auto min, auto max>
+constexpr bool all_in_interval_closed(span<const T> values)
+{
+    return detail::allSatisfy<detail::check_interval<detail::interval_type::closed, T, min, max>>(values);
+}
+
+template<typename T, auto min, auto max>
+constexpr bool all_in_interval_open(span<const T> values)
+{
+    return detail::allSatisfy<detail::check_interval<detail::interval_type::open, T, min, max>>(values);
+}
+
+template<typename T>
+constexpr bool all_not_negative(span<const T> values)
+{
+    return detail::allSatisfy<detail::check_not_negative>(values);
+}
+
+template<
+        typename TRange,
+        typename T = std::remove_const_t<detail::range_element_t<const TRange>>,
+        std::enable_if_t<detail::is_span_compatible_range<const TRange&, const T>::value>* = nullptr>
+constexpr bool all_not_negative(const TRange& values)
+{
+    return all_not_negative(span<const T>{values});
+}
+
+template<typename TCheck, typename T>
+class refined;
+
+namespace detail {
+
+template<typename T>
+struct is_refined : std::false_type {};
+
+template<typename TCheck, typename T>
+struct is_refined<refined<TCheck, T>> : std::true_type {};
+
+// A refined span validated from a temporary container would outlive the checked elements
+template<typename T, typename... TArgs>
+struct is_span_of_temporary : std::false_type {};
+
+template<typename T, typename TArg>
+struct is_span_of_temporary<span<T>, TArg>
+    : std::bool_constant<!std::is_lvalue_reference_v<TArg> && !is_span<std::decay_t<TArg>>::value &&
+                         std::is_constructible_v<span<T>, TArg&&>> {};
+
+template<typename TFromInterval, typename TToInterval>
+constexpr bool isSubinterval()
+{
+    using T = std::remove_cv_t<decltype(TFromInterval::lowerBound)>;
+    if constexpr (std::is_integral_v<T>) {
+        // Compare closed bounds of integer values
+        constexpr auto closedBounds = [](auto interval)
+        {
+            using Interval = decltype(interval);
+            return std::pair<T, T>{
+                    Interval::isLowerBoundIncluded ? Interval::lowerBound : static_cast<T>(Interval::lowerBound + 1),
+                    Interval::isUpperBoundIncluded ? Interval::upperBound : static_cast<T>(Interval::upperBound - 1)};
+        };
+        constexpr auto from = closedBounds(TFromInterval{});
+        constexpr auto to = closedBounds(TToInterval{});
+        return from.first >= to.first && from.second <= to.second;
+    }
+    else {
+        constexpr auto isLowerBoundInside = TFromInterval::lowerBound > TToInterval::lowerBound ||
+                (TFromInterval::lowerBound == TToInterval::lowerBound &&
+                 (TToInterval::isLowerBoundIncluded || !TFromInterval::isLowerBoundIncluded));
+        constexpr auto isUpperBoundInside = TFromInterval::upperBound < TToInterval::upperBound ||
+                (TFromInterval::upperBound == TToInterval::upperBound &&
+                 (TToInterval::isUpperBoundIncluded || !TFromInterval::isUpperBoundIncluded));
+        return isLowerBoundInside && isUpperBoundInside;
+    }
+}
+
+} //namespace detail
+
+///
+/// Trait telling that values passing TFromCheck always pass TToCheck, it allows implicit unchecked conversions between
+/// refined types. Can be specialized for user-defined checks.
+///
+template<typename TFromCheck, typename TToCheck>
+struct refinement_implies : std::is_same<TFromCheck, TToCheck> {};
+
+template<
+        detail::interval_type fromIntervalType,
+        detail::interval_type toIntervalType,
+        typename T,
+        auto fromMin,
+        auto fromMax,
+        auto toMin,
+        auto toMax>
+struct refinement_implies<
+        detail::check_interval<fromIntervalType, T, fromMin, fromMax>,
+        detail::check_interval<toIntervalType, T, toMin, toMax>> {
+    static constexpr bool value = detail::isSubinterval<
+            detail::check_interval<fromIntervalType, T, fromMin, fromMax>,
+            detail::check_interval<toIntervalType, T, toMin, toMax>>();
+};
+
+template<detail::interval_type intervalType, typename T, auto min, auto max>
+struct refinement_implies<detail::check_interval<intervalType, T, min, max>, detail::check_not_negative> {
+    using interval = detail::check_interval<intervalType, T, min, max>;
+    static constexpr bool value = interval::lowerBound >= 0 ||
+            (std::is_integral_v<T> && !interval::isLowerBoundIncluded && interval::lowerBound + 1 >= 0);
+};
+
+template<typename TFromElementCheck, typename TToElementCheck>
+struct refinement_implies<detail::check_all<TFromElementCheck>, detail::check_all<TToElementCheck>>
+    : refinement_implies<TFromElementCheck, TToElementCheck> {};
+
+template<typename TFromCheck, typename TToCheck>
+inline constexpr auto refinement_implies_v = refinement_implies<TFromCheck, TToCheck>::value;
+
+///
+/// A copyable and movable counterpart of arg_precondition: the value is checked once on construction,
+/// and the check is a part of the type, so the validated value can be stored and passed on without rechecking.
+/// The value can't be modified through the wrapper. Conversions between refined types are implicit and unchecked
+/// when refinement_implies_v<TOtherCheck, TCheck> is true.
+/// A moved-from refined value can only be destroyed or assigned to.
+///
+template<typename TCheck, typename T>
+class refined {
+    static_assert(!std::is_reference_v<T>, "sfun::refined stores values, use arg_precondition for references");
+
+public:
+    using value_type = T;
+    using check_type = TCheck;
+
+    template<
+            typename... TArgs,
+            std::enable_if_t<
+                    std::is_constructible_v<T, TArgs&&...> &&
+                    (sizeof...(TArgs) != 1 || !(detail::is_refined<std::decay_t<TArgs>>::value || ...)) &&
+                    !detail::is_span_of_temporary<T, TArgs...>::value>* = nullptr>
+    constexpr refined(TArgs&&... val)
+        : value_(std::forward<TArgs>(val)...)
+    {
+        std::invoke(TCheck{}, value_);
+    }
+
+    template<typename TArg, std::enable_if_t<detail::is_span_of_temporary<T, TArg>::value>* = nullptr>
+    refined(TArg&&) = delete;
+
+    template<
+            typename TOtherCheck,
+            std::enable_if_t<
+                    !std::is_same_v<TOtherCheck, TCheck> && refinement_implies_v<TOtherCheck, TCheck>>* = nullptr>
+    constexpr refined(const refined<TOtherCheck, T>& other)
+        : value_(other.get())
+    {
+    }
+
+    template<
+            typename TOtherCheck,
+            std::enable_if_t<
+                    !std::is_same_v<TOtherCheck, TCheck> && refinement_implies_v<TOtherCheck, TCheck>>* = nullptr>
+    constexpr refined(refined<TOtherCheck, T>&& other)
+        : value_(std::move(other).get())
+    {
+    }
+
+    constexpr const T& get() const&
+    {
+        return value_;
+    }
+
+    constexpr T&& get() &&
+    {
+        return std::move(value_);
+    }
+
+    constexpr operator const T&() const&
+    {
+        return value_;
+    }
+
+    constexpr operator T&&() &&
+    {
+        return std::move(value_);
+    }
+
+private:
+    T value_;
+};
+
+template<typename T>
+using refined_not_empty = refined<detail::check_not_empty, T>;
+
+template<typename T>
+using refined_valid = refined<detail::check_valid, T>;
+
+template<typename T, auto min, auto max>
+using refined_interval = refined<detail::check_interval<detail::interval_type::half_open, T, min, max>, T>;
+
+template<typename T, auto min, auto max>
+using refined_interval_closed = refined<detail::check_interval<detail::interval_type::closed, T, min, max>, T>;
+
+template<typename T, auto min, auto max>
+using refined_interval_open = refined<detail::check_interval<detail::interval_type::open, T, min, max>, T>;
+
+template<typename T>
+using refined_not_negative = refined<detail::check_not_negative, T>;
+
+/// A span of elements validated with TElementCheck once on construction, it can't be created from temporary containers
+template<typename TElementCheck, typename T>
+using checked_span = refined<detail::check_all<TElementCheck>, span<const T>>;
+
+template<typename T, auto min, auto max>
+using checked_span_interval = checked_span<detail::check_interval<detail::interval_type::half_open, T, min, max>, T>;
+
+template<typename T, auto min, auto max>
+using checked_span_interval_closed =
+        checked_span<detail::check_interval<detail::interval_type::closed, T, min, max>, T>;
+
+template<typename T, auto min, auto max>
+using checked_span_interval_open = checked_span<detail::check_interval<detail::interval_type::open, T, min, max>, T>;
+
+template<typename T>
+using checked_span_not_negative = checked_span<detail::check_not_negative, T>;
+
 } //namespace sfun
 
 #endif //SFUN_PRECONDITION_H
@@ -0,0 +1,175 @@
+#ifndef SFUN_SEQLOCK_MEMBER_H
+#define SFUN_SEQLOCK_MEMBER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace sfun {
+
+///
+/// A member for read-mostly values shared between threads, protected by a sequence lock.
+/// Readers copy the value optimistically and retry if a write happened meanwhile, they never block writers or
+/// each other and don't modify shared memory. Writers are serialized by the sequence counter and never wait for
+/// readers. The value is stored in relaxed atomic words, so the concurrent copying is free of data races.
+///
+template<typename T>
+class seqlock_member {
+    static_assert(std::is_trivially_copyable_v<T>, "sfun::seqlock_member supports only trivially copyable types");
+    static_assert(std::is_default_constructible_v<T>, "sfun::seqlock_member requires a default constructible type");
+
+    using word = std::size_t;
+    static_assert(std::atomic<word>::is_always_lock_free);
+    static constexpr auto wordCount = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+public:
+    seqlock_member()
+        : seqlock_member{T{}}
+    {
+    }
+
+    seqlock_member(const T& value)
+    {
+        writeWords(value);
+    }
+
+    seqlock_member(const seqlock_member& other)
+        : seqlock_member{other.load()}
+    {
+    }
+
+    seqlock_member& operator=(const seqlock_member& other)
+    {
+        if (this != &other)
+            store(other.load());
+        return *this;
+    }
+
+    seqlock_member& operator=(const T& value)
+    {
+        store(value);
+        return *this;
+    }
+
+    T load() const
+    {
+        return fromWords(loadWords().second);
+    }
+
+    T get() const
+    {
+        return load();
+    }
+
+    operator T() const
+    {
+        return load();
+    }
+
+    void store(const T& value)
+    {
+        const auto sequence = lockWrite();
+        writeWords(value);
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /// Calls f(T&) with a copy of the current value outside the lock and stores the result if no other write happened
+    /// meanwhile, otherwise f is called again with the new value, so it can be called several times.
+    /// If f throws, the stored value isn't changed.
+    template<typename F>
+    void update(F&& f)
+    {
+        while (true) {
+            auto [sequence, words] = loadWords();
+            auto value = fromWords(words);
+            f(value);
+            if (tryLockWrite(sequence)) {
+                writeWords(value);
+                sequence_.store(sequence + 2, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+private:
+    // Returns a consistent copy of the value words and the even counter value they were read at
+    std::pair<word, std::array<word, wordCount>> loadWords() const
+    {
+        while (true) {
+            const auto sequence = sequence_.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            const auto words = readWords();
+            // Orders the value loads before the counter check
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == sequence)
+                return {sequence, words};
+        }
+    }
+
+    // Makes the counter odd, returns its previous value
+    word lockWrite()
+    {
+        auto sequence = sequence_.load(std::memory_order_relaxed);
+        while (true) {
+            if (sequence & 1) {
+                std::this_thread::yield();
+                sequence = sequence_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (tryLockWrite(sequence))
+                return sequence;
+        }
+    }
+
+    // Makes the counter odd if it still has the even value sequence, otherwise loads the current value into sequence
+    bool tryLockWrite(word& sequence)
+    {
+        if (!sequence_.compare_exchange_strong(
+                    sequence,
+                    sequence + 1,
+                    std::memory_order_acquire,
+                    std::memory_order_relaxed))
+            return false;
+        // Orders the counter update before the value stores
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    std::array<word, wordCount> readWords() const
+    {
+        auto words = std::array<word, wordCount>{};
+        for (auto i = std::size_t{}; i < wordCount; ++i)
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        return words;
+    }
+
+    static T fromWords(const std::array<word, wordCount>& words)
+    {
+        auto value = T{};
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    void writeWords(const T& value)
+    {
+        auto words = std::array<word, wordCount>{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (auto i = std::size_t{}; i < wordCount; ++i)
+            words_[i].store(words[i], std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<word> sequence_ = 0;
+    std::array<std::atomic<word>, wordCount> words_{};
+};
+
+} //namespace sfun
+
+#endif //SFUN_SEQLOCK_MEMBER_H
@@ -0,0 +1,245 @@
+#ifndef SFUN_SIGNAL_H
+#define SFUN_SIGNAL_H
+
+#include "detail/thread_stripes.h"
+#include "functional.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace sfun {
+
+enum class signal_connection : std::size_t {};
+
+///
+/// A signal broadcasting calls to the connected slots.
+/// Emission is wait-free and doesn't allocate: it reads an immutable array of slots published through an atomic
+/// pointer. Connecting and disconnecting copy the array under a mutex. The replaced arrays are tagged with the current
+/// epoch and deleted by a later connection change (or the signal's destructor) once all emissions that could have
+/// read them are finished. Emissions are tracked by counters striped across threads, the last emission on a stripe
+/// only tries to advance the epoch if the mutex is free, so disconnected slots are never destroyed during emission.
+/// Slots are stored in sfun::inplace_function, so they must fit into its inline storage.
+///
+template<typename... Args>
+class signal {
+public:
+    using slot_type = inplace_function<void(Args...)>;
+
+private:
+    struct Slot {
+        signal_connection connection;
+        slot_type function;
+    };
+
+    // Disconnected slots are kept alive by the retired lists that still reference them.
+    using SlotList = std::vector<std::shared_ptr<const Slot>>;
+
+    struct RetiredSlotList {
+        std::unique_ptr<const SlotList> slots;
+        std::size_t epoch;
+    };
+
+    // Emissions are counted separately for odd and even epochs, so the counter of the previous epoch drains
+    // while new emissions keep starting.
+    struct alignas(64) EmitterStripe {
+        std::atomic<std::size_t> activeEmitCount[2] = {};
+    };
+
+    class EmitGuard {
+    public:
+        explicit EmitGuard(const signal& sig)
+            : signal_{sig}
+            , stripe_{sig.stripes_[detail::threadStripeIndex() % sig.stripeCount_]}
+            , parity_{sig.epoch_.load(std::memory_order_relaxed) % 2}
+        {
+            stripe_.activeEmitCount[parity_].fetch_add(1, std::memory_order_seq_cst);
+        }
+        ~EmitGuard()
+        {
+            if (stripe_.activeEmitCount[parity_].fetch_sub(1, std::memory_order_release) == 1 &&
+                signal_.retiredCount_.load(std::memory_order_relaxed) != 0)
+                signal_.advanceEpochAfterEmit();
+        }
+        EmitGuard(const EmitGuard&) = delete;
+        EmitGuard& operator=(const EmitGuard&) = delete;
+
+    private:
+        const signal& signal_;
+        EmitterStripe& stripe_;
+        std::size_t parity_;
+    };
+
+public:
+    signal()
+        : stripeCount_{detail::threadStripeCount()}
+        , stripes_{std::make_unique<EmitterStripe[]>(stripeCount_)}
+    {
+    }
+    signal(const signal&) = delete;
+    signal& operator=(const signal&) = delete;
+    signal(signal&&) = delete;
+    signal& operator=(signal&&) = delete;
+
+    ~signal()
+    {
+        delete slots_.load(std::memory_order_acquire);
+    }
+
+    template<typename F>
+    signal_connection connect(F&& f)
+    {
+        auto reclaimed = std::vector<RetiredSlotList>{};
+        auto lock = std::lock_guard{mutex_};
+        const auto connection = signal_connection{nextConnection_++};
+        auto slot = std::make_shared<Slot>(Slot{connection, slot_type{std::forward<F>(f)}});
+        update(
+                [&slot](SlotList& slots)
+                {
+                    slots.push_back(std::move(slot));
+                });
+        reclaimed = reclaim();
+        return connection;
+    }
+
+    bool disconnect(signal_connection connection)
+    {
+        auto reclaimed = std::vector<RetiredSlotList>{};
+        auto lock = std::lock_guard{mutex_};
+        auto disconnected = false;
+        update(
+                [&](SlotList& slots)
+                {
+                    auto it = std::find_if(
+                            slots.begin(),
+                            slots.end(),
+                            [connection](const auto& slot)
+                            {
+                                return slot->connection == connection;
+                            });
+                    if (it != slots.end()) {
+                        slots.erase(it);
+                        disconnected = true;
+                    }
+                });
+        reclaimed = reclaim();
+        return disconnected;
+    }
+
+    void disconnect_all()
+    {
+        auto reclaimed = std::vector<RetiredSlotList>{};
+        auto lock = std::lock_guard{mutex_};
+        update(
+                [](SlotList& slots)
+                {
+                    slots.clear();
+                });
+        reclaimed = reclaim();
+    }
+
+    std::size_t size() const
+    {
+        auto guard = EmitGuard{*this};
+        const auto* slots = slots_.load(std::memory_order_seq_cst);
+        return slots ? slots->size() : 0;
+    }
+
+    template<typename... TArgs>
+    void emit(TArgs&&... args) const
+    {
+        auto guard = EmitGuard{*this};
+        const auto* slots = slots_.load(std::memory_order_seq_cst);
+        if (!slots)
+            return;
+        for (const auto& slot : *slots)
+            slot->function(args...);
+    }
+
+    template<typename... TArgs>
+    void operator()(TArgs&&... args) const
+    {
+        emit(std::forward<TArgs>(args)...);
+    }
+
+private:
+    template<typename TModifier>
+    void update(TModifier&& modify)
+    {
+        const auto* prevSlots = slots_.load(std::memory_order_relaxed);
+        auto slots = prevSlots ? std::make_unique<SlotList>(*prevSlots) : std::make_unique<SlotList>();
+        modify(*slots);
+        slots_.store(slots.release(), std::memory_order_seq_cst);
+        if (prevSlots) {
+            retired_.push_back({std::unique_ptr<const SlotList>{prevSlots}, epoch_.load(std::memory_order_relaxed)});
+            retiredCount_.store(retired_.size(), std::memory_order_relaxed);
+        }
+    }
+
+    bool hasActiveEmissions(std::size_t parity) const
+    {
+        for (auto i = std::size_t{}; i < stripeCount_; ++i)
+            if (stripes_[i].activeEmitCount[parity].load(std::memory_order_seq_cst) != 0)
+                return true;
+        return false;
+    }
+
+    // Must be called under the mutex. An emission that read a list retired at epoch N had started before the list
+    // was replaced, so it's counted under the parity of N or N - 1, or of an even older epoch. Advancing the epoch
+    // to N + 1 and then to N + 2 requires both counters to drain after the replacement, so such an emission is
+    // finished, and the list can be deleted. The deleted lists are returned to be destroyed outside the mutex,
+    // as their slots can call back into the signal.
+    std::vector<RetiredSlotList> reclaim()
+    {
+        advanceEpoch();
+        const auto epoch = epoch_.load(std::memory_order_relaxed);
+        const auto reclaimedEnd = std::find_if(
+                retired_.begin(),
+                retired_.end(),
+                [epoch](const RetiredSlotList& retired)
+                {
+                    return epoch - retired.epoch < 2;
+                });
+        auto reclaimed = std::vector<RetiredSlotList>{
+                std::make_move_iterator(retired_.begin()),
+                std::make_move_iterator(reclaimedEnd)};
+        retired_.erase(retired_.begin(), reclaimedEnd);
+        retiredCount_.store(retired_.size(), std::memory_order_relaxed);
+        return reclaimed;
+    }
+
+    // Must be called under the mutex, doesn't allocate or delete anything, so it can be used by emissions
+    void advanceEpoch() const
+    {
+        for (auto step = 0; step < 2 && retiredCount_.load(std::memory_order_relaxed) != 0; ++step) {
+            const auto epoch = epoch_.load(std::memory_order_relaxed);
+            if (hasActiveEmissions((epoch + 1) % 2))
+                break;
+            epoch_.store(epoch + 1, std::memory_order_seq_cst);
+        }
+    }
+
+    void advanceEpochAfterEmit() const
+    {
+        auto lock = std::unique_lock{mutex_, std::try_to_lock};
+        if (lock)
+            advanceEpoch();
+    }
+
+private:
+    std::atomic<const SlotList*> slots_ = nullptr;
+    std::size_t stripeCount_;
+    std::unique_ptr<EmitterStripe[]> stripes_;
+    mutable std::atomic<std::size_t> epoch_ = 0;
+    std::atomic<std::size_t> retiredCount_ = 0;
+    mutable std::mutex mutex_;
+    std::vector<RetiredSlotList> retired_;
+    std::size_t nextConnection_ = 0;
+};
+
+} //namespace sfun
+
+#endif //SFUN_SIGNAL_H
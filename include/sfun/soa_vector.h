@@ -0,0 +1,179 @@
+#ifndef SFUN_SOA_VECTOR_H
+#define SFUN_SOA_VECTOR_H
+
+#include "contract.h"
+#include "span.h"
+#include "type_list.h"
+#include "utility.h"
+#include <cstddef>
+#include <exception>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sfun {
+
+template<typename TList>
+class soa_vector;
+
+namespace detail {
+template<typename T>
+using SoaColumn = std::vector<T>;
+}
+
+///
+/// A struct-of-arrays container: each element type of the type_list is stored in its own contiguous column.
+/// Rows are accessed through tuples of references.
+///
+template<typename... Ts>
+class soa_vector<type_list<Ts...>> {
+    using list = type_list<Ts...>;
+    using columns = to_tuple_t<decltype(list::template transform<detail::SoaColumn>())>;
+    static_assert(sizeof...(Ts) > 0, "soa_vector requires at least one column");
+    static_assert(
+            !list::template contains<bool>(),
+            "soa_vector can't store bool columns, as std::vector<bool> isn't contiguous; use char instead");
+
+public:
+    using value_type = to_tuple_t<list>;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+    using size_type = std::size_t;
+
+    template<std::size_t I>
+    using column_type = typename decltype(list::template at<I>())::type;
+
+    soa_vector() = default;
+
+    std::size_t size() const noexcept
+    {
+        return std::get<0>(columns_).size();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    void reserve(std::size_t capacity)
+    {
+        tuple_for_each(
+                columns_,
+                [capacity](auto& column)
+                {
+                    column.reserve(capacity);
+                });
+    }
+
+    void clear() noexcept
+    {
+        tuple_for_each(
+                columns_,
+                [](auto& column)
+                {
+                    column.clear();
+                });
+    }
+
+    template<typename... TArgs>
+    void emplace_back(TArgs&&... fields)
+    {
+        static_assert(sizeof...(TArgs) == sizeof...(Ts), "soa_vector::emplace_back requires a value for each column");
+        emplaceBack(std::forward_as_tuple(std::forward<TArgs>(fields)...), std::index_sequence_for<Ts...>{});
+    }
+
+    void push_back(const value_type& row)
+    {
+        emplaceBack(row, std::index_sequence_for<Ts...>{});
+    }
+
+    void push_back(value_type&& row)
+    {
+        emplaceBack(std::move(row), std::index_sequence_for<Ts...>{});
+    }
+
+    void pop_back()
+    {
+        sfun_precondition(!empty());
+        tuple_for_each(
+                columns_,
+                [](auto& column)
+                {
+                    column.pop_back();
+                });
+    }
+
+    reference operator[](std::size_t index)
+    {
+        sfun_precondition(index < size());
+        return makeRow<reference>(columns_, index, std::index_sequence_for<Ts...>{});
+    }
+
+    const_reference operator[](std::size_t index) const
+    {
+        sfun_precondition(index < size());
+        return makeRow<const_reference>(columns_, index, std::index_sequence_for<Ts...>{});
+    }
+
+    template<std::size_t I>
+    span<column_type<I>> column()
+    {
+        auto& column = std::get<I>(columns_);
+        return {column.data(), column.size()};
+    }
+
+    template<std::size_t I>
+    span<const column_type<I>> column() const
+    {
+        const auto& column = std::get<I>(columns_);
+        return {column.data(), column.size()};
+    }
+
+    template<typename T>
+    span<T> column()
+    {
+        return column<list::template index_of<T>()>();
+    }
+
+    template<typename T>
+    span<const T> column() const
+    {
+        return column<list::template index_of<T>()>();
+    }
+
+private:
+    // Columns are grown one by one, so if constructing a field throws,
+    // the already appended fields are removed to keep all columns the same size.
+    template<typename TTuple, std::size_t... I>
+    void emplaceBack(TTuple&& fields, std::index_sequence<I...>)
+    {
+        const auto prevSize = size();
+        try {
+            (static_cast<void>(std::get<I>(columns_).emplace_back(std::get<I>(std::forward<TTuple>(fields)))), ...);
+        }
+        catch (...) {
+            tuple_for_each(
+                    columns_,
+                    [prevSize](auto& column)
+                    {
+                        if (column.size() > prevSize)
+                            column.pop_back();
+                    });
+            throw;
+        }
+    }
+
+    template<typename TRow, typename TColumns, std::size_t... I>
+    static TRow makeRow(TColumns& columns, std::size_t index, std::index_sequence<I...>)
+    {
+        return TRow{std::get<I>(columns)[index]...};
+    }
+
+private:
+    columns columns_;
+};
+
+} //namespace sfun
+
+#endif //SFUN_SOA_VECTOR_H
@@ -0,0 +1,132 @@
+#ifndef SFUN_SPAN_H
+#define SFUN_SPAN_H
+
+#include "contract.h"
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace sfun {
+
+template<typename T>
+class span;
+
+namespace detail {
+
+template<typename T>
+struct is_span : std::false_type {};
+
+template<typename T>
+struct is_span<span<T>> : std::true_type {};
+
+template<typename TRange>
+using range_element_t = std::remove_pointer_t<decltype(std::data(std::declval<TRange&>()))>;
+
+template<typename TRange, typename T, typename = void>
+struct is_span_compatible_range : std::false_type {};
+
+// Contiguous ranges providing data() and size(), including C arrays and std::array.
+// Rvalue ranges are accepted only for spans of const elements, as in std::span.
+template<typename TRange, typename T>
+struct is_span_compatible_range<
+        TRange,
+        T,
+        std::void_t<decltype(std::data(std::declval<TRange&>())), decltype(std::size(std::declval<TRange&>()))>>
+    : std::bool_constant<
+              !is_span<std::remove_cv_t<std::remove_reference_t<TRange>>>::value &&
+              std::is_convertible_v<range_element_t<TRange> (*)[], T (*)[]> &&
+              (std::is_lvalue_reference_v<TRange> || std::is_const_v<T>)> {};
+
+} //namespace detail
+
+///
+/// A minimal non-owning view of a contiguous sequence with a dynamic extent, a subset of C++20 std::span
+///
+template<typename T>
+class span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+
+    constexpr span() noexcept = default;
+    constexpr span(T* data, std::size_t size) noexcept
+        : data_{data}
+        , size_{size}
+    {
+    }
+
+    template<typename TRange, std::enable_if_t<detail::is_span_compatible_range<TRange, T>::value>* = nullptr>
+    constexpr span(TRange&& range) noexcept(noexcept(std::data(range)) && noexcept(std::size(range)))
+        : data_{std::data(range)}
+        , size_{std::size(range)}
+    {
+    }
+
+    template<typename U, std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>* = nullptr>
+    constexpr span(const span<U>& other) noexcept
+        : data_{other.data()}
+        , size_{other.size()}
+    {
+    }
+
+    constexpr T* data() const noexcept
+    {
+        return data_;
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    constexpr T& operator[](std::size_t index) const
+    {
+        sfun_precondition(index < size_);
+        return data_[index];
+    }
+
+    constexpr T& front() const
+    {
+        sfun_precondition(!empty());
+        return data_[0];
+    }
+
+    constexpr T& back() const
+    {
+        sfun_precondition(!empty());
+        return data_[size_ - 1];
+    }
+
+    constexpr T* begin() const noexcept
+    {
+        return data_;
+    }
+
+    constexpr T* end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+template<typename TRange>
+span(TRange&&) -> span<detail::range_element_t<TRange>>;
+
+} //namespace sfun
+
+#endif //SFUN_SPAN_H
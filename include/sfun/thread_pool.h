@@ -0,0 +1,570 @@
+#ifndef SFUN_THREAD_POOL_H
+#define SFUN_THREAD_POOL_H
+
+#include "contract.h"
+#include "expected.h"
+#include "functional.h"
+#include "utility.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sfun {
+
+class thread_pool;
+
+namespace detail {
+
+class ThreadPoolTask {
+public:
+    virtual ~ThreadPoolTask() = default;
+    virtual void run() = 0;
+};
+
+template<typename F>
+class ThreadPoolFunctionTask : public ThreadPoolTask {
+public:
+    explicit ThreadPoolFunctionTask(F f)
+        : f_{std::move(f)}
+    {
+    }
+
+    void run() override
+    {
+        f_();
+    }
+
+private:
+    F f_;
+};
+
+///
+/// Chase-Lev work-stealing deque (the C11 version from "Correct and Efficient Work-Stealing for Weak Memory Models").
+/// Only the owner thread calls push() and pop(), any thread can call steal().
+///
+class ChaseLevDeque {
+    struct Array {
+        explicit Array(std::int64_t capacity)
+            : capacity{capacity}
+            , items{std::make_unique<std::atomic<ThreadPoolTask*>[]>(static_cast<std::size_t>(capacity))}
+        {
+        }
+
+        std::atomic<ThreadPoolTask*>& operator[](std::int64_t index)
+        {
+            return items[static_cast<std::size_t>(index & (capacity - 1))];
+        }
+
+        std::int64_t capacity;
+        std::unique_ptr<std::atomic<ThreadPoolTask*>[]> items;
+    };
+
+public:
+    ChaseLevDeque()
+    {
+        arrays_.push_back(std::make_unique<Array>(initialCapacity));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    ~ChaseLevDeque()
+    {
+        while (auto task = pop())
+            delete task;
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    void push(ThreadPoolTask* task)
+    {
+        const auto bottom = bottom_.load(std::memory_order_relaxed);
+        const auto top = top_.load(std::memory_order_acquire);
+        auto array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > array->capacity - 1)
+            array = grow(array, top, bottom);
+        (*array)[bottom].store(task, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    ThreadPoolTask* pop()
+    {
+        const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        auto array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = top_.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto task = (*array)[bottom].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // The last item, race against the thieves for it
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                task = nullptr;
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    ThreadPoolTask* steal()
+    {
+        auto top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+
+        auto array = array_.load(std::memory_order_acquire);
+        auto task = (*array)[top].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return task;
+    }
+
+private:
+    // Replaced arrays can still be read by thieves, so they're kept until the deque is destroyed.
+    Array* grow(Array* array, std::int64_t top, std::int64_t bottom)
+    {
+        arrays_.push_back(std::make_unique<Array>(array->capacity * 2));
+        auto newArray = arrays_.back().get();
+        for (auto i = top; i < bottom; ++i)
+            (*newArray)[i].store((*array)[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        array_.store(newArray, std::memory_order_release);
+        return newArray;
+    }
+
+private:
+    static constexpr auto initialCapacity = std::int64_t{256};
+
+    alignas(64) std::atomic<std::int64_t> top_ = 0;
+    alignas(64) std::atomic<std::int64_t> bottom_ = 0;
+    std::atomic<Array*> array_ = nullptr;
+    std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+struct ThreadPoolWorkerContext {
+    const thread_pool* pool = nullptr;
+    std::size_t workerIndex = 0;
+};
+
+inline ThreadPoolWorkerContext& threadPoolWorkerContext()
+{
+    thread_local auto context = ThreadPoolWorkerContext{};
+    return context;
+}
+
+// Completion flag that can be waited on from outside the pool;
+// it's only accessed under the mutex, so the state can be destroyed right after the wait.
+class ThreadPoolCompletion {
+public:
+    void set()
+    {
+        auto lock = std::lock_guard{mutex_};
+        isDone_ = true;
+        doneCondition_.notify_all();
+    }
+
+    bool isDone() const
+    {
+        auto lock = std::lock_guard{mutex_};
+        return isDone_;
+    }
+
+    void wait() const
+    {
+        auto lock = std::unique_lock{mutex_};
+        doneCondition_.wait(
+                lock,
+                [this]
+                {
+                    return isDone_;
+                });
+    }
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::condition_variable doneCondition_;
+    bool isDone_ = false;
+};
+
+template<typename R>
+struct TaskHandleState {
+    ThreadPoolCompletion completion;
+    std::optional<expected<R, std::exception_ptr>> result;
+};
+
+} //namespace detail
+
+///
+/// A handle to the result of a task submitted to sfun::thread_pool.
+/// Exceptions thrown by the task are captured and stored in the result.
+///
+template<typename R>
+class task_handle {
+public:
+    bool is_ready() const
+    {
+        return state_->completion.isDone();
+    }
+
+    /// Waits for the task; when called from a worker of the same pool, the pool's tasks are executed meanwhile.
+    void wait() const;
+
+    /// Returns the task result or rethrows the exception thrown by the task.
+    /// The result is moved out of the handle, so like std::future::get() it can be called only once.
+    /// Use result() for repeated access.
+    R get()
+    {
+        wait();
+        auto& result = *state_->result;
+        if (!result)
+            std::rethrow_exception(result.error());
+        if constexpr (std::is_void_v<R>)
+            return;
+        else if constexpr (std::is_reference_v<R>)
+            return *result;
+        else
+            return std::move(*result);
+    }
+
+    /// Returns the task result or the captured exception.
+    expected<R, std::exception_ptr>& result()
+    {
+        wait();
+        return *state_->result;
+    }
+
+private:
+    task_handle(thread_pool& pool, std::shared_ptr<detail::TaskHandleState<R>> state)
+        : pool_{&pool}
+        , state_{std::move(state)}
+    {
+    }
+
+private:
+    thread_pool* pool_;
+    std::shared_ptr<detail::TaskHandleState<R>> state_;
+
+    friend class thread_pool;
+};
+
+///
+/// A work-stealing thread pool: each worker owns a Chase-Lev deque, tasks spawned by a worker are pushed to its deque,
+/// and idle workers steal from the others. Tasks submitted from other threads are placed into a shared queue.
+/// Idle workers sleep until new tasks are submitted.
+///
+class thread_pool {
+    struct alignas(64) Worker {
+        detail::ChaseLevDeque deque;
+        std::uint64_t randomState = 0;
+    };
+
+public:
+    /// Creates the pool with threadCount workers (hardware concurrency when 0)
+    explicit thread_pool(int threadCount = 0)
+    {
+        if (threadCount <= 0)
+            threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        workerCount_ = static_cast<std::size_t>(threadCount);
+        workers_ = std::make_unique<Worker[]>(workerCount_);
+        threads_.reserve(workerCount_);
+        try {
+            for (auto i = std::size_t{}; i < workerCount_; ++i) {
+                workers_[i].randomState = i + 1;
+                threads_.emplace_back(
+                        [this, i]
+                        {
+                            runWorker(i);
+                        });
+            }
+        }
+        catch (...) {
+            // threads_ is destroyed with the partially constructed pool, stop() joins the workers started so far
+            stop();
+            throw;
+        }
+    }
+
+    /// Waits until all submitted tasks are finished
+    ~thread_pool()
+    {
+        stop();
+        for (auto task : sharedQueue_)
+            delete task;
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    thread_pool(thread_pool&&) = delete;
+    thread_pool& operator=(thread_pool&&) = delete;
+
+    int thread_count() const
+    {
+        return static_cast<int>(workerCount_);
+    }
+
+    template<typename F>
+    auto submit(F&& f)
+    {
+        using result_type = detail::try_invoke_expected_value_t<std::invoke_result_t<std::decay_t<F>&>>;
+        auto state = std::make_shared<detail::TaskHandleState<result_type>>();
+        schedule(makeTask(
+                [state, f = std::forward<F>(f)]() mutable
+                {
+                    state->result.emplace(try_invoke_expected(f));
+                    state->completion.set();
+                }));
+        return task_handle<result_type>{*this, std::move(state)};
+    }
+
+    ///
+    /// Calls f(index_t i) for each i in [begin, end) using all workers and waits for the completion.
+    /// The range is split recursively in halves down to grain sized chunks, so idle workers steal large subranges.
+    /// If f throws, the remaining indices are skipped and the first exception is rethrown.
+    ///
+    template<typename F>
+    void parallel_for(index_t begin, index_t end, index_t grain, F&& f)
+    {
+        sfun_precondition(grain > 0);
+        if (begin >= end)
+            return;
+
+        auto state = ParallelForState<std::remove_reference_t<F>>{f, grain, end - begin};
+        if (isWorkerThread()) {
+            runRange(state, begin, end);
+            helpUntil(state.completion);
+        }
+        else {
+            schedule(makeTask(
+                    [this, &state, begin, end]
+                    {
+                        runRange(state, begin, end);
+                    }));
+            state.completion.wait();
+        }
+        if (state.error)
+            std::rethrow_exception(state.error);
+    }
+
+private:
+    template<typename F>
+    struct ParallelForState {
+        ParallelForState(F& f, index_t grain, index_t size)
+            : f{f}
+            , grain{grain}
+            , remaining{size}
+        {
+        }
+
+        F& f;
+        index_t grain;
+        std::atomic<index_t> remaining;
+        std::atomic<bool> hasError = false;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        detail::ThreadPoolCompletion completion;
+    };
+
+    template<typename F>
+    static std::unique_ptr<detail::ThreadPoolTask> makeTask(F&& f)
+    {
+        return std::make_unique<detail::ThreadPoolFunctionTask<std::decay_t<F>>>(std::forward<F>(f));
+    }
+
+    template<typename F>
+    void runRange(ParallelForState<F>& state, index_t begin, index_t end)
+    {
+        while (end - begin > state.grain) {
+            const auto middle = begin + (end - begin) / 2;
+            schedule(makeTask(
+                    [this, &state, middle, end]
+                    {
+                        runRange(state, middle, end);
+                    }));
+            end = middle;
+        }
+
+        if (!state.hasError.load(std::memory_order_relaxed)) {
+            try {
+                for (auto i = begin; i < end; ++i)
+                    state.f(i);
+            }
+            catch (...) {
+                auto lock = std::lock_guard{state.errorMutex};
+                if (!state.error)
+                    state.error = std::current_exception();
+                state.hasError.store(true, std::memory_order_relaxed);
+            }
+        }
+        if (state.remaining.fetch_sub(end - begin, std::memory_order_acq_rel) == end - begin)
+            state.completion.set();
+    }
+
+    void stop()
+    {
+        {
+            auto lock = std::lock_guard{sleepMutex_};
+            isStopped_.store(true, std::memory_order_seq_cst);
+        }
+        sleepCondition_.notify_all();
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    bool isWorkerThread() const
+    {
+        return detail::threadPoolWorkerContext().pool == this;
+    }
+
+    void schedule(std::unique_ptr<detail::ThreadPoolTask> task)
+    {
+        // The queues take ownership only when pushing succeeds, growing them can throw
+        const auto& context = detail::threadPoolWorkerContext();
+        if (context.pool == this) {
+            workers_[context.workerIndex].deque.push(task.get());
+            task.release();
+        }
+        else {
+            auto lock = std::lock_guard{sharedQueueMutex_};
+            sharedQueue_.push_back(task.get());
+            task.release();
+            sharedQueueSize_.store(sharedQueue_.size(), std::memory_order_relaxed);
+        }
+
+        queuedTaskCount_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepingWorkerCount_.load(std::memory_order_seq_cst) > 0) {
+            auto lock = std::lock_guard{sleepMutex_};
+            sleepCondition_.notify_one();
+        }
+    }
+
+    detail::ThreadPoolTask* findTask(std::size_t workerIndex)
+    {
+        auto& worker = workers_[workerIndex];
+        auto task = worker.deque.pop();
+        if (!task)
+            task = popSharedQueue();
+        if (!task && workerCount_ > 1) {
+            // xorshift64 to pick a random victim to start stealing from
+            auto& state = worker.randomState;
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            const auto first = static_cast<std::size_t>(state % workerCount_);
+            for (auto i = std::size_t{}; i < workerCount_ && !task; ++i) {
+                const auto victim = (first + i) % workerCount_;
+                if (victim != workerIndex)
+                    task = workers_[victim].deque.steal();
+            }
+        }
+        if (task)
+            queuedTaskCount_.fetch_sub(1, std::memory_order_seq_cst);
+        return task;
+    }
+
+    detail::ThreadPoolTask* popSharedQueue()
+    {
+        // Idle workers probe the queue constantly, so its emptiness is checked without taking the lock.
+        // The size is published before queuedTaskCount_ is incremented, so a worker woken by a submitted task sees it.
+        if (sharedQueueSize_.load(std::memory_order_acquire) == 0)
+            return nullptr;
+
+        auto lock = std::lock_guard{sharedQueueMutex_};
+        if (sharedQueue_.empty())
+            return nullptr;
+        auto task = sharedQueue_.front();
+        sharedQueue_.pop_front();
+        sharedQueueSize_.store(sharedQueue_.size(), std::memory_order_relaxed);
+        return task;
+    }
+
+    static void runTask(detail::ThreadPoolTask* task)
+    {
+        auto taskPtr = std::unique_ptr<detail::ThreadPoolTask>{task};
+        taskPtr->run();
+    }
+
+    void helpUntil(const detail::ThreadPoolCompletion& completion)
+    {
+        const auto workerIndex = detail::threadPoolWorkerContext().workerIndex;
+        while (!completion.isDone()) {
+            if (auto task = findTask(workerIndex))
+                runTask(task);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void runWorker(std::size_t workerIndex)
+    {
+        detail::threadPoolWorkerContext() = {this, workerIndex};
+        constexpr auto spinCount = 64;
+        while (true) {
+            auto task = static_cast<detail::ThreadPoolTask*>(nullptr);
+            for (auto i = 0; i < spinCount && !task; ++i) {
+                task = findTask(workerIndex);
+                if (!task)
+                    std::this_thread::yield();
+            }
+            if (task) {
+                runTask(task);
+                continue;
+            }
+
+            auto lock = std::unique_lock{sleepMutex_};
+            sleepingWorkerCount_.fetch_add(1, std::memory_order_seq_cst);
+            sleepCondition_.wait(
+                    lock,
+                    [this]
+                    {
+                        return isStopped_.load(std::memory_order_seq_cst) ||
+                                queuedTaskCount_.load(std::memory_order_seq_cst) > 0;
+                    });
+            sleepingWorkerCount_.fetch_sub(1, std::memory_order_seq_cst);
+            if (isStopped_.load(std::memory_order_seq_cst) && queuedTaskCount_.load(std::memory_order_seq_cst) <= 0)
+                return;
+        }
+    }
+
+private:
+    std::size_t workerCount_ = 0;
+    std::unique_ptr<Worker[]> workers_;
+    std::vector<std::thread> threads_;
+    std::mutex sharedQueueMutex_;
+    std::deque<detail::ThreadPoolTask*> sharedQueue_;
+    std::atomic<std::size_t> sharedQueueSize_ = 0;
+    std::atomic<std::ptrdiff_t> queuedTaskCount_ = 0;
+    std::atomic<int> sleepingWorkerCount_ = 0;
+    std::atomic<bool> isStopped_ = false;
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondition_;
+
+    template<typename R>
+    friend class task_handle;
+};
+
+template<typename R>
+void task_handle<R>::wait() const
+{
+    if (pool_->isWorkerThread())
+        pool_->helpUntil(state_->completion);
+    else
+        state_->completion.wait();
+}
+
+} //namespace sfun
+
+#endif //SFUN_THREAD_POOL_H
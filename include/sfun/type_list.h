@@ -3,6 +3,7 @@
 
 #include "type_traits.h"
 #include "utility.h"
+#include <array>
 #include <tuple>
 
 namespace sfun {
@@ -14,22 +15,125 @@ namespace detail {
 template<typename... T>
 struct TypeList {};
 
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define SFUN_HAS_TYPE_PACK_ELEMENT
+#endif
+#endif
+
 template<typename TList, std::size_t I>
 struct TypeListAt;
 
-template<typename TFront, typename... TBack>
-struct TypeListAt<TypeList<TFront, TBack...>, 0> {
-    using type = TFront;
+#ifdef SFUN_HAS_TYPE_PACK_ELEMENT
+
+template<typename... Ts, std::size_t I>
+struct TypeListAt<TypeList<Ts...>, I> {
+    static_assert(I < sizeof...(Ts), "type_list index is out of range");
+    using type = __type_pack_element<I, Ts...>;
 };
 
-template<typename TFront, typename... TBack, std::size_t I>
-struct TypeListAt<TypeList<TFront, TBack...>, I> {
-    using type = typename TypeListAt<TypeList<TBack...>, I - 1>::type;
+#else
+
+template<std::size_t I, typename T>
+struct IndexedType {
+    using type = T;
 };
 
+template<typename TIndexSequence, typename... Ts>
+struct IndexedTypes;
+
+template<std::size_t... I, typename... Ts>
+struct IndexedTypes<std::index_sequence<I...>, Ts...> : IndexedType<I, Ts>... {};
+
+template<std::size_t I, typename T>
+constexpr auto selectIndexedType(const IndexedType<I, T>&) -> IndexedType<I, T>;
+
+template<typename... Ts, std::size_t I>
+struct TypeListAt<TypeList<Ts...>, I> {
+    static_assert(I < sizeof...(Ts), "type_list index is out of range");
+    using type = typename decltype(selectIndexedType<I>(
+            std::declval<IndexedTypes<std::index_sequence_for<Ts...>, Ts...>>()))::type;
+};
+
+#endif //SFUN_HAS_TYPE_PACK_ELEMENT
+
 template<typename TList, std::size_t... I>
 constexpr auto makeTypeListSlice(std::index_sequence<I...>) -> type_list<typename TypeListAt<TList, I>::type...>;
 
+template<std::size_t N>
+struct TypeListIndices {
+    std::array<std::size_t, N> data{};
+    std::size_t size = 0;
+};
+
+template<std::size_t N>
+constexpr auto selectTypeListIndices(const std::array<bool, N>& mask)
+{
+    auto result = TypeListIndices<N>{};
+    for (auto i = std::size_t{}; i < N; ++i)
+        if (mask[i])
+            result.data[result.size++] = i;
+    return result;
+}
+
+// Elements are picked through the constant-depth TypeListAt, so filtering instantiates
+// one template per selected element instead of recursing over the whole list.
+template<typename TList, typename TMask>
+struct TypeListFilter;
+
+template<typename... Ts, typename TMask>
+struct TypeListFilter<TypeList<Ts...>, TMask> {
+    static constexpr auto indices = selectTypeListIndices(TMask::value);
+
+    template<std::size_t... I>
+    static auto make(std::index_sequence<I...>) -> type_list<typename TypeListAt<TypeList<Ts...>, indices.data[I]>::type...>;
+
+    using type = decltype(make(std::make_index_sequence<indices.size>{}));
+};
+
+template<template<typename> typename TPredicate, typename... Ts>
+struct TypeListPredicateMask {
+    static constexpr auto value = std::array<bool, sizeof...(Ts)>{static_cast<bool>(TPredicate<Ts>::value)...};
+};
+
+template<typename T>
+inline constexpr char typeListTag = 0;
+
+template<std::size_t N>
+constexpr auto makeFirstOccurrenceMask(const std::array<const void*, N>& tags)
+{
+    auto result = std::array<bool, N>{};
+    for (auto i = std::size_t{}; i < N; ++i) {
+        result[i] = true;
+        for (auto j = std::size_t{}; j < i; ++j)
+            if (tags[j] == tags[i]) {
+                result[i] = false;
+                break;
+            }
+    }
+    return result;
+}
+
+// Types are compared by the addresses of their tag variables during constant evaluation,
+// which avoids instantiating a trait for every pair of elements.
+template<typename... Ts>
+struct TypeListUniqueMask {
+    static constexpr auto value =
+            makeFirstOccurrenceMask(std::array<const void*, sizeof...(Ts)>{&typeListTag<Ts>...});
+};
+
+template<std::size_t N>
+constexpr std::size_t findFirstTypeListMatch(const std::array<bool, N>& matches)
+{
+    for (auto i = std::size_t{}; i < N; ++i)
+        if (matches[i])
+            return i;
+    return N;
+}
+
+template<typename... Ts, typename... Us>
+constexpr auto operator+(type_list<Ts...>, type_list<Us...>) -> type_list<Ts..., Us...>;
+
 } //namespace detail
 
 template<typename... Ts>
@@ -54,7 +158,88 @@ public:
         static_assert(First + Size <= size());
         return decltype(detail::makeTypeListSlice<list>(make_index_range<First, First + Size>{})){};
     }
+
+    template<typename T>
+    static constexpr bool contains()
+    {
+        return (std::is_same_v<T, Ts> || ...);
+    }
+
+    template<typename T>
+    static constexpr std::size_t index_of()
+    {
+        static_assert(contains<T>(), "type_list doesn't contain the specified type");
+        return detail::findFirstTypeListMatch(std::array<bool, sizeof...(Ts)>{std::is_same_v<T, Ts>...});
+    }
+
+    template<template<typename> typename TTransform>
+    static constexpr auto transform()
+    {
+        return type_list<TTransform<Ts>...>{};
+    }
+
+    template<template<typename> typename TPredicate>
+    static constexpr auto filter()
+    {
+        return typename detail::TypeListFilter<list, detail::TypeListPredicateMask<TPredicate, Ts...>>::type{};
+    }
+
+    static constexpr auto unique()
+    {
+        return typename detail::TypeListFilter<list, detail::TypeListUniqueMask<Ts...>>::type{};
+    }
+};
+
+template<typename... TLists>
+constexpr auto concat(TLists...)
+{
+    using namespace detail;
+    return decltype((type_list<>{} + ... + TLists{})){};
+}
+
+/// Index of the first occurrence of T in TList, usable as a small RTTI-free type id.
+template<typename T, typename TList>
+inline constexpr std::size_t type_index_of = TList::template index_of<T>();
+
+namespace detail {
+template<typename F, typename... Ts>
+constexpr void forEachType(F& f, type_list<Ts...>)
+{
+    (static_cast<void>(f(type_identity<Ts>{})), ...);
+}
+} //namespace detail
+
+/// Calls f(type_identity<T>{}) for each element T of TList, the loop is fully unrolled.
+template<typename TList, typename F>
+constexpr void for_each_type(F&& f)
+{
+    detail::forEachType(f, TList{});
+}
+
+struct trusted_index_t {
+    explicit trusted_index_t() = default;
 };
+inline constexpr auto trusted_index = trusted_index_t{};
+
+/// Calls f with type_identity of the TList element at the runtime index, the index must be less than TList::size().
+template<typename TList, typename F>
+constexpr decltype(auto) visit_index(trusted_index_t, std::size_t index, F&& f)
+{
+    static_assert(TList::size() > 0, "sfun::visit_index can't be used with an empty type_list");
+    return detail::dispatchIndex<TList::size()>(
+            index,
+            [&f](auto i) -> decltype(auto)
+            {
+                return std::forward<F>(f)(TList::template at<decltype(i)::value>());
+            });
+}
+
+template<typename TList, typename F>
+constexpr decltype(auto) visit_index(std::size_t index, F&& f)
+{
+    sfun_precondition(index < static_cast<std::size_t>(TList::size()));
+    return visit_index<TList>(trusted_index, index, std::forward<F>(f));
+}
 
 template<std::size_t I, typename... TListArgs>
 constexpr auto get(const type_list<TListArgs...>&)
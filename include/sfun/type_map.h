@@ -0,0 +1,101 @@
+#ifndef SFUN_TYPE_MAP_H
+#define SFUN_TYPE_MAP_H
+
+#include "contract.h"
+#include "type_list.h"
+#include <array>
+#include <cstddef>
+#include <exception>
+
+namespace sfun {
+
+template<typename TList, typename V>
+class type_map;
+
+///
+/// A map with a value per type of the type_list, stored in a flat array and indexed by sfun::type_index_of,
+/// so lookups don't need hashing or RTTI.
+///
+template<typename... Ts, typename V>
+class type_map<type_list<Ts...>, V> {
+    using list = type_list<Ts...>;
+    static_assert(
+            decltype(list::unique())::size() == list::size(),
+            "type_map requires the type_list to contain unique types");
+
+public:
+    using key_list = list;
+    using value_type = V;
+    using iterator = typename std::array<V, sizeof...(Ts)>::iterator;
+    using const_iterator = typename std::array<V, sizeof...(Ts)>::const_iterator;
+
+    constexpr type_map() = default;
+
+    constexpr explicit type_map(const V& value)
+    {
+        for (auto& item : values_)
+            item = value;
+    }
+
+    template<typename T>
+    static constexpr std::size_t index_of()
+    {
+        return type_index_of<T, list>;
+    }
+
+    static constexpr std::size_t size()
+    {
+        return sizeof...(Ts);
+    }
+
+    template<typename T>
+    constexpr V& get()
+    {
+        return values_[index_of<T>()];
+    }
+
+    template<typename T>
+    constexpr const V& get() const
+    {
+        return values_[index_of<T>()];
+    }
+
+    constexpr V& operator[](std::size_t index)
+    {
+        sfun_precondition(index < size());
+        return values_[index];
+    }
+
+    constexpr const V& operator[](std::size_t index) const
+    {
+        sfun_precondition(index < size());
+        return values_[index];
+    }
+
+    constexpr iterator begin() noexcept
+    {
+        return values_.begin();
+    }
+
+    constexpr iterator end() noexcept
+    {
+        return values_.end();
+    }
+
+    constexpr const_iterator begin() const noexcept
+    {
+        return values_.begin();
+    }
+
+    constexpr const_iterator end() const noexcept
+    {
+        return values_.end();
+    }
+
+private:
+    std::array<V, sizeof...(Ts)> values_{};
+};
+
+} //namespace sfun
+
+#endif //SFUN_TYPE_MAP_H
@@ -3,8 +3,10 @@
 
 #include "contract.h"
 #include "type_traits.h"
+#include <algorithm>
 #include <cstddef>
 #include <exception>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -42,6 +44,126 @@ constexpr auto shiftSequence(std::index_sequence<Ints...>) -> std::index_sequenc
 template<std::size_t Begin, std::size_t End>
 using make_index_range = decltype(detail::shiftSequence<Begin>(std::make_index_sequence<End - Begin>()));
 
+namespace detail {
+template<typename F, std::size_t... I>
+constexpr void staticFor(F& f, std::index_sequence<I...>)
+{
+    (static_cast<void>(f(std::integral_constant<std::size_t, I>{})), ...);
+}
+
+template<typename TTuple, typename F, std::size_t... I>
+constexpr void tupleForEach(TTuple&& tuple, F& f, std::index_sequence<I...>)
+{
+    (static_cast<void>(f(std::get<I>(std::forward<TTuple>(tuple)))), ...);
+}
+} //namespace detail
+
+/// Calls f(std::integral_constant<std::size_t, I>{}) for each I in [Begin, End), the loop is fully unrolled.
+template<std::size_t Begin, std::size_t End, typename F>
+constexpr void static_for(F&& f)
+{
+    static_assert(Begin <= End, "sfun::static_for requires Begin <= End");
+    detail::staticFor(f, make_index_range<Begin, End>{});
+}
+
+/// Calls f with each element of a tuple-like object (std::tuple, std::pair, std::array), the loop is fully unrolled.
+template<typename TTuple, typename F>
+constexpr void tuple_for_each(TTuple&& tuple, F&& f)
+{
+    detail::tupleForEach(
+            std::forward<TTuple>(tuple),
+            f,
+            std::make_index_sequence<std::tuple_size_v<std::remove_reference_t<TTuple>>>{});
+}
+
+namespace detail {
+
+template<std::size_t I, typename F>
+constexpr decltype(auto) invokeWithIndex(F&& f)
+{
+    return std::forward<F>(f)(std::integral_constant<std::size_t, I>{});
+}
+
+template<std::size_t N, typename F, typename TIndexSequence = std::make_index_sequence<N>>
+struct IndexDispatchTable;
+
+template<std::size_t N, typename F, std::size_t... I>
+struct IndexDispatchTable<N, F, std::index_sequence<I...>> {
+    using result_type = decltype(invokeWithIndex<0>(std::declval<F>()));
+    static_assert(
+            (std::is_same_v<result_type, decltype(invokeWithIndex<I>(std::declval<F>()))> && ...),
+            "sfun: the visitor must return the same type for all alternatives");
+
+    static constexpr result_type (*value[])(F&&) = {&invokeWithIndex<I, F>...};
+};
+
+inline constexpr auto indexDispatchSwitchSize = std::size_t{16};
+inline constexpr auto indexDispatchMaxSwitchSize = std::size_t{64};
+
+// Each switch handles 16 indices starting from Base and passes the larger ones to the next switch.
+// Cases past N are never taken and reuse the last index to stay well-formed.
+template<std::size_t Base, std::size_t N, typename F>
+constexpr decltype(auto) indexDispatchSwitch(std::size_t index, F&& f)
+{
+    switch (index - Base) {
+    case 0:
+        return invokeWithIndex<std::min(Base, N - 1)>(std::forward<F>(f));
+    case 1:
+        return invokeWithIndex<std::min(Base + 1, N - 1)>(std::forward<F>(f));
+    case 2:
+        return invokeWithIndex<std::min(Base + 2, N - 1)>(std::forward<F>(f));
+    case 3:
+        return invokeWithIndex<std::min(Base + 3, N - 1)>(std::forward<F>(f));
+    case 4:
+        return invokeWithIndex<std::min(Base + 4, N - 1)>(std::forward<F>(f));
+    case 5:
+        return invokeWithIndex<std::min(Base + 5, N - 1)>(std::forward<F>(f));
+    case 6:
+        return invokeWithIndex<std::min(Base + 6, N - 1)>(std::forward<F>(f));
+    case 7:
+        return invokeWithIndex<std::min(Base + 7, N - 1)>(std::forward<F>(f));
+    case 8:
+        return invokeWithIndex<std::min(Base + 8, N - 1)>(std::forward<F>(f));
+    case 9:
+        return invokeWithIndex<std::min(Base + 9, N - 1)>(std::forward<F>(f));
+    case 10:
+        return invokeWithIndex<std::min(Base + 10, N - 1)>(std::forward<F>(f));
+    case 11:
+        return invokeWithIndex<std::min(Base + 11, N - 1)>(std::forward<F>(f));
+    case 12:
+        return invokeWithIndex<std::min(Base + 12, N - 1)>(std::forward<F>(f));
+    case 13:
+        return invokeWithIndex<std::min(Base + 13, N - 1)>(std::forward<F>(f));
+    case 14:
+        return invokeWithIndex<std::min(Base + 14, N - 1)>(std::forward<F>(f));
+    case 15:
+        return invokeWithIndex<std::min(Base + 15, N - 1)>(std::forward<F>(f));
+    default:
+        if constexpr (Base + indexDispatchSwitchSize < N)
+            return indexDispatchSwitch<Base + indexDispatchSwitchSize, N>(index, std::forward<F>(f));
+        else
+            unreachable();
+    }
+}
+
+// Calls f(std::integral_constant<std::size_t, I>{}) with I equal to the runtime index, which must be less than N.
+// Up to indexDispatchMaxSwitchSize indices are dispatched with switches, so f can be inlined into each branch,
+// otherwise a table of function pointers is used.
+template<std::size_t N, typename F>
+constexpr decltype(auto) dispatchIndex(std::size_t index, F&& f)
+{
+    static_assert(N > 0);
+    if constexpr (N <= indexDispatchMaxSwitchSize) {
+        // The table is still instantiated to check that all return types match.
+        static_cast<void>(sizeof(IndexDispatchTable<N, F&&>));
+        return indexDispatchSwitch<0, N>(index, std::forward<F>(f));
+    }
+    else
+        return IndexDispatchTable<N, F&&>::value[index](std::forward<F>(f));
+}
+
+} //namespace detail
+
 template<typename T>
 constexpr decltype(auto) deref(T&& obj)
 {
@@ -0,0 +1,139 @@
+#include <sfun/contract.h>
+#include <gtest/gtest.h>
+#include <exception>
+#include <string>
+
+namespace {
+
+constexpr int half(int value)
+{
+    sfun_precondition(value % 2 == 0);
+    sfun_precondition_audit(value >= 0);
+    return value / 2;
+}
+
+struct ContractViolation {
+    std::string condition;
+    std::string file;
+    int line;
+};
+
+void throwContractViolation(const char* condition, const char* file, int line)
+{
+    throw ContractViolation{condition, file, line};
+}
+
+} //namespace
+
+static_assert(
+        SFUN_CONTRACT_LEVEL == SFUN_CONTRACT_LEVEL_OFF || SFUN_CONTRACT_LEVEL == SFUN_CONTRACT_LEVEL_DEFAULT ||
+        SFUN_CONTRACT_LEVEL == SFUN_CONTRACT_LEVEL_AUDIT);
+
+TEST(Contract, Constexpr)
+{
+    static_assert(half(4) == 2);
+    EXPECT_EQ(half(8), 4);
+}
+
+#if SFUN_CONTRACT_LEVEL == SFUN_CONTRACT_LEVEL_OFF
+TEST(Contract, OffLevelChecksAreNotPerformed)
+{
+    auto prevHandler = sfun::set_contract_violation_handler(throwContractViolation);
+    auto checkCount = 0;
+    auto check = [&checkCount]
+    {
+        ++checkCount;
+        return false;
+    };
+    // Conditions of the regular checks become assumptions, so only the satisfied ones can be used here
+    auto value = 4;
+    sfun_precondition(value % 2 == 0);
+    sfun_postcondition(value > 0);
+    sfun_invariant(value < 10);
+    // Conditions calling functions must compile without warnings
+    auto name = std::string{"sfun"};
+    sfun_precondition(!name.empty());
+    sfun_precondition_audit(check());
+    sfun_postcondition_audit(check());
+    sfun_invariant_audit(check());
+    EXPECT_EQ(checkCount, 0);
+    EXPECT_EQ(half(8), 4);
+    sfun::set_contract_violation_handler(prevHandler);
+}
+#else
+TEST(Contract, ChecksAreEvaluated)
+{
+    auto checkCount = 0;
+    auto check = [&checkCount]
+    {
+        ++checkCount;
+        return true;
+    };
+    sfun_precondition(check());
+    sfun_postcondition(check());
+    sfun_invariant(check());
+    EXPECT_EQ(checkCount, 3);
+}
+#endif
+
+#if SFUN_CONTRACT_LEVEL == SFUN_CONTRACT_LEVEL_DEFAULT
+TEST(Contract, AuditChecksAreNotEvaluated)
+{
+    auto checkCount = 0;
+    auto check = [&checkCount]
+    {
+        ++checkCount;
+        return false;
+    };
+    sfun_precondition_audit(check());
+    sfun_postcondition_audit(check());
+    sfun_invariant_audit(check());
+    EXPECT_EQ(checkCount, 0);
+}
+#endif
+
+#if SFUN_CONTRACT_LEVEL == SFUN_CONTRACT_LEVEL_AUDIT
+TEST(Contract, AuditChecksAreEvaluated)
+{
+    auto checkCount = 0;
+    auto check = [&checkCount]
+    {
+        ++checkCount;
+        return true;
+    };
+    sfun_precondition_audit(check());
+    sfun_postcondition_audit(check());
+    sfun_invariant_audit(check());
+    EXPECT_EQ(checkCount, 3);
+}
+
+TEST(Contract, AuditViolationHandler)
+{
+    auto prevHandler = sfun::set_contract_violation_handler(throwContractViolation);
+    auto value = -1;
+    EXPECT_THROW(sfun_precondition_audit(value >= 0), ContractViolation);
+    EXPECT_THROW(half(-2), ContractViolation);
+    sfun::set_contract_violation_handler(prevHandler);
+}
+#endif
+
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
+TEST(Contract, ViolationHandler)
+{
+    auto prevHandler = sfun::set_contract_violation_handler(throwContractViolation);
+    EXPECT_EQ(prevHandler, nullptr);
+    auto value = 3;
+    const auto line = __LINE__ + 2;
+    try {
+        sfun_precondition(value % 2 == 0);
+        FAIL();
+    }
+    catch (const ContractViolation& violation) {
+        EXPECT_EQ(violation.condition, "value % 2 == 0");
+        EXPECT_NE(violation.file.find("test_contract.cpp"), std::string::npos);
+        EXPECT_EQ(violation.line, line);
+    }
+    EXPECT_THROW(half(1), ContractViolation);
+    EXPECT_EQ(sfun::set_contract_violation_handler(prevHandler), throwContractViolation);
+}
+#endif
@@ -0,0 +1,120 @@
+#ifndef SFUN_CONTRACT_PROFILING
+#define SFUN_CONTRACT_PROFILING
+#endif
+#include <sfun/contract.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Checks aren't performed at the OFF level, so there's nothing to count
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
+
+namespace {
+
+constexpr int twice(int value)
+{
+    sfun_precondition(value < 1000);
+    return value * 2;
+}
+
+bool isPositive(int value)
+{
+    sfun_precondition(value > 0);
+    return true;
+}
+
+template<typename T>
+bool isNotEmpty(const T& value)
+{
+    sfun_precondition(!value.empty());
+    return true;
+}
+
+const sfun::contract_check_stats* findStats(
+        const std::vector<sfun::contract_check_stats>& stats,
+        const std::string& condition)
+{
+    for (const auto& site : stats)
+        if (site.condition == condition)
+            return &site;
+    return nullptr;
+}
+
+// Counters are global for the process, so the tests check the hits added since the previous snapshot
+std::uint64_t hitCount(const std::string& condition)
+{
+    auto stats = sfun::contract_check_stats_top();
+    auto siteStats = findStats(stats, condition);
+    return siteStats ? siteStats->hit_count : 0;
+}
+
+} //namespace
+
+TEST(ContractProfiling, CountsHits)
+{
+    const auto prevTwiceHitCount = hitCount("value < 1000");
+    const auto prevIsPositiveHitCount = hitCount("value > 0");
+    static_assert(twice(2) == 4);
+    for (auto i = 1; i <= 100; ++i)
+        twice(i);
+    for (auto i = 1; i <= 10; ++i)
+        isPositive(i);
+
+    auto stats = sfun::contract_check_stats_top();
+    auto twiceStats = findStats(stats, "value < 1000");
+    ASSERT_TRUE(twiceStats);
+    EXPECT_EQ(twiceStats->hit_count - prevTwiceHitCount, 100);
+    EXPECT_NE(std::string{twiceStats->file}.find("test_contract_profiling.cpp"), std::string::npos);
+    auto isPositiveStats = findStats(stats, "value > 0");
+    ASSERT_TRUE(isPositiveStats);
+    EXPECT_EQ(isPositiveStats->hit_count - prevIsPositiveHitCount, 10);
+    EXPECT_GT(isPositiveStats->line, twiceStats->line);
+}
+
+TEST(ContractProfiling, TopIsSortedAndLimited)
+{
+    twice(1);
+    isPositive(1);
+    auto stats = sfun::contract_check_stats_top();
+    ASSERT_GE(stats.size(), 2);
+    for (auto i = std::size_t{1}; i < stats.size(); ++i)
+        EXPECT_GE(stats[i - 1].hit_count, stats[i].hit_count);
+
+    auto topStats = sfun::contract_check_stats_top(1);
+    ASSERT_EQ(topStats.size(), 1);
+    EXPECT_EQ(topStats[0].hit_count, stats[0].hit_count);
+}
+
+TEST(ContractProfiling, MergesTemplateInstantiations)
+{
+    const auto prevHitCount = hitCount("!value.empty()");
+    isNotEmpty(std::string{"a"});
+    isNotEmpty(std::vector<int>{1});
+    isNotEmpty(std::vector<int>{1});
+    auto stats = sfun::contract_check_stats_top();
+    auto notEmptyStats = findStats(stats, "!value.empty()");
+    ASSERT_TRUE(notEmptyStats);
+    EXPECT_EQ(notEmptyStats->hit_count - prevHitCount, 3);
+}
+
+TEST(ContractProfiling, CountsHitsFromThreads)
+{
+    const auto prevHitCount = hitCount("value > 0");
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 4; ++i)
+        threads.emplace_back(
+                []
+                {
+                    for (auto j = 1; j <= 1000; ++j)
+                        isPositive(j);
+                });
+    for (auto& thread : threads)
+        thread.join();
+    auto stats = sfun::contract_check_stats_top();
+    auto isPositiveStats = findStats(stats, "value > 0");
+    ASSERT_TRUE(isPositiveStats);
+    EXPECT_EQ(isPositiveStats->hit_count - prevHitCount, 4000);
+}
+#endif
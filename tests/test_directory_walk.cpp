@@ -0,0 +1,88 @@
+#include <sfun/directory_walk.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class DirectoryWalk : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        root_ = fs::temp_directory_path() / "sfun_test_directory_walk";
+        fs::remove_all(root_);
+        for (auto i = 0; i < 4; ++i) {
+            auto dir = root_ / ("dir" + std::to_string(i)) / "nested";
+            fs::create_directories(dir);
+            for (auto j = 0; j < 300; ++j)
+                std::ofstream{dir / ("file" + std::to_string(j))};
+            std::ofstream{dir.parent_path() / "file"};
+        }
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(root_);
+    }
+
+    std::set<std::string> expectedEntries() const
+    {
+        auto result = std::set<std::string>{};
+        for (auto& entry : fs::recursive_directory_iterator{root_})
+            result.insert(entry.path().string());
+        return result;
+    }
+
+    fs::path root_;
+};
+
+} //namespace
+
+TEST_F(DirectoryWalk, MatchesRecursiveDirectoryIterator)
+{
+    for (auto threadCount : {1, 4, 16}) {
+        auto mutex = std::mutex{};
+        auto entries = std::set<std::string>{};
+        auto entryCount = 0;
+        sfun::walk_directory(
+                root_,
+                [&](std::string_view directory, const std::vector<std::string_view>& names)
+                {
+                    auto lock = std::lock_guard{mutex};
+                    for (auto name : names) {
+                        entries.insert((fs::path{directory} / name).string());
+                        ++entryCount;
+                    }
+                },
+                threadCount);
+        EXPECT_EQ(entries, expectedEntries());
+        EXPECT_EQ(entryCount, static_cast<int>(entries.size()));
+    }
+}
+
+TEST_F(DirectoryWalk, HandlerExceptionIsRethrown)
+{
+    EXPECT_THROW(
+            sfun::walk_directory(
+                    root_,
+                    [](std::string_view, const std::vector<std::string_view>&)
+                    {
+                        throw std::runtime_error{"error"};
+                    },
+                    4),
+            std::runtime_error);
+}
+
+TEST_F(DirectoryWalk, RootIsNotDirectory)
+{
+    EXPECT_THROW(
+            sfun::walk_directory(
+                    root_ / "dir0" / "file",
+                    [](std::string_view, const std::vector<std::string_view>&) {}),
+            fs::filesystem_error);
+}
@@ -0,0 +1,78 @@
+#include <sfun/expected.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using namespace sfun;
+
+TEST(Expected, Value)
+{
+    auto result = expected<std::string, int>{"value"};
+    ASSERT_TRUE(result);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), "value");
+    EXPECT_EQ(*result, "value");
+    EXPECT_EQ(result->size(), 5u);
+    EXPECT_EQ(result.value_or("default"), "value");
+}
+
+TEST(Expected, Error)
+{
+    auto result = expected<std::string, int>{unexpected{42}};
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error(), 42);
+    EXPECT_EQ(result.value_or("default"), "default");
+}
+
+TEST(Expected, SameValueAndErrorTypes)
+{
+    auto value = expected<int, int>{1};
+    auto error = expected<int, int>{unexpected{2}};
+    ASSERT_TRUE(value);
+    EXPECT_EQ(value.value(), 1);
+    ASSERT_FALSE(error);
+    EXPECT_EQ(error.error(), 2);
+}
+
+TEST(Expected, Reference)
+{
+    auto str = std::string{"value"};
+    auto result = expected<std::string&, int>{str};
+    ASSERT_TRUE(result);
+    EXPECT_EQ(&result.value(), &str);
+    result.value() = "changed";
+    EXPECT_EQ(str, "changed");
+
+    auto constResult = expected<const std::string&, int>{str};
+    EXPECT_TRUE((std::is_same_v<decltype(constResult.value()), const std::string&>));
+    EXPECT_EQ(&*constResult, &str);
+}
+
+TEST(Expected, Void)
+{
+    auto result = expected<void, std::string>{};
+    EXPECT_TRUE(result);
+    EXPECT_TRUE((std::is_same_v<decltype(result.value()), void>));
+
+    auto error = expected<void, std::string>{unexpected{std::string{"error"}}};
+    ASSERT_FALSE(error);
+    EXPECT_EQ(error.error(), "error");
+}
+
+TEST(Expected, MoveOnly)
+{
+    auto result = expected<std::unique_ptr<int>, int>{std::make_unique<int>(42)};
+    auto value = std::move(result).value();
+    ASSERT_TRUE(value);
+    EXPECT_EQ(*value, 42);
+}
+
+TEST(Expected, Constexpr)
+{
+    constexpr auto value = expected<int, int>{1};
+    static_assert(value.has_value());
+    static_assert(value.value() == 1);
+    constexpr auto error = expected<int, int>{unexpected{2}};
+    static_assert(!error.has_value());
+    static_assert(error.error() == 2);
+}
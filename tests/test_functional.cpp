@@ -1,5 +1,10 @@
 #include <sfun/functional.h>
 #include <gtest/gtest.h>
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <variant>
 
 using namespace sfun;
 
@@ -19,3 +24,414 @@ TEST(Functional, Basic)
 
     EXPECT_TRUE((std::is_same_v<callable_return_type<Foo>, bool>));
 }
+
+namespace {
+
+int triple(int value)
+{
+    return value * 3;
+}
+
+struct Counter {
+    int value = 0;
+
+    int add(int x)
+    {
+        value += x;
+        return value;
+    }
+};
+
+int callTwice(function_ref<int(int)> f, int value)
+{
+    return f(f(value));
+}
+
+} //namespace
+
+TEST(Functional, FunctionRefLambda)
+{
+    auto offset = 1;
+    auto addOffset = [&offset](int value)
+    {
+        return value + offset;
+    };
+    EXPECT_EQ(callTwice(addOffset, 1), 3);
+    offset = 10;
+    EXPECT_EQ(callTwice(addOffset, 1), 21);
+}
+
+TEST(Functional, FunctionRefFunction)
+{
+    EXPECT_EQ(callTwice(triple, 2), 18);
+    EXPECT_EQ(callTwice(&triple, 2), 18);
+}
+
+TEST(Functional, FunctionRefMemberFunction)
+{
+    auto counter = Counter{};
+    auto add = &Counter::add;
+    auto ref = function_ref<int(Counter&, int)>{add};
+    EXPECT_EQ(ref(counter, 2), 2);
+    EXPECT_EQ(ref(counter, 3), 5);
+    EXPECT_EQ(counter.value, 5);
+}
+
+static_assert(!std::is_constructible_v<function_ref<int(Counter&, int)>, decltype(&Counter::add)>);
+static_assert(!std::is_convertible_v<decltype(&Counter::add), function_ref<int(Counter&, int)>>);
+
+TEST(Functional, FunctionRefMemberFunctionLvalue)
+{
+    static constexpr auto add = &Counter::add;
+    auto counter = Counter{};
+    auto ref = function_ref<int(Counter&, int)>{add};
+    EXPECT_EQ(ref(counter, 4), 4);
+    auto value = &Counter::value;
+    auto valueRef = function_ref<int&(Counter&)>{value};
+    EXPECT_EQ(valueRef(counter), 4);
+}
+
+TEST(Functional, FunctionRefStatefulCallable)
+{
+    auto callCount = 0;
+    auto counter = [&callCount]() mutable
+    {
+        ++callCount;
+    };
+    auto ref = function_ref<void()>{counter};
+    ref();
+    ref();
+    EXPECT_EQ(callCount, 2);
+}
+
+TEST(Functional, FunctionRefReturnConversion)
+{
+    auto ref = function_ref<void(int)>{triple};
+    ref(1);
+    auto longRef = function_ref<long(int)>{triple};
+    EXPECT_EQ(longRef(2), 6L);
+}
+
+TEST(Functional, FunctionRefDeduction)
+{
+    auto lambda = [](int value, const std::string& str)
+    {
+        return str.size() + static_cast<std::size_t>(value);
+    };
+    auto ref = function_ref{lambda};
+    EXPECT_TRUE((std::is_same_v<decltype(ref), function_ref<std::size_t(int, const std::string&)>>));
+    EXPECT_EQ(ref(1, "abc"), 4u);
+
+    auto functionRef = function_ref{triple};
+    EXPECT_TRUE((std::is_same_v<decltype(functionRef), function_ref<int(int)>>));
+}
+
+TEST(Functional, FunctionRefIsTriviallyCopyable)
+{
+    EXPECT_TRUE((std::is_trivially_copyable_v<function_ref<int(int)>>));
+    EXPECT_EQ(sizeof(function_ref<int(int)>), 2 * sizeof(void*));
+}
+
+TEST(Functional, InplaceFunction)
+{
+    auto offset = 10;
+    auto f = inplace_function<int(int)>{[offset](int value)
+                                        {
+                                            return value + offset;
+                                        }};
+    ASSERT_TRUE(f);
+    EXPECT_EQ(f(1), 11);
+
+    auto g = inplace_function<int(int)>{triple};
+    EXPECT_EQ(g(2), 6);
+
+    auto empty = inplace_function<int(int)>{};
+    EXPECT_FALSE(empty);
+}
+
+TEST(Functional, InplaceFunctionMoveOnlyCallable)
+{
+    auto ptr = std::make_unique<int>(42);
+    auto f = inplace_function<int()>{[ptr = std::move(ptr)]
+                                     {
+                                         return *ptr;
+                                     }};
+    auto moved = std::move(f);
+    EXPECT_FALSE(f);
+    ASSERT_TRUE(moved);
+    EXPECT_EQ(moved(), 42);
+
+    auto assigned = inplace_function<int()>{};
+    assigned = std::move(moved);
+    EXPECT_FALSE(moved);
+    EXPECT_EQ(assigned(), 42);
+
+    assigned = nullptr;
+    EXPECT_FALSE(assigned);
+}
+
+TEST(Functional, InplaceFunctionDestroysTarget)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        auto f = inplace_function<long()>{[counter]
+                                          {
+                                              return counter.use_count();
+                                          }};
+        EXPECT_EQ(counter.use_count(), 2);
+        auto moved = std::move(f);
+        EXPECT_EQ(counter.use_count(), 2);
+        EXPECT_EQ(moved(), 2);
+        moved.reset();
+        EXPECT_EQ(counter.use_count(), 1);
+        moved = inplace_function<long()>{[counter]
+                                         {
+                                             return counter.use_count();
+                                         }};
+        EXPECT_EQ(counter.use_count(), 2);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(Functional, InplaceFunctionNoexcept)
+{
+    auto f = inplace_function<int(int) noexcept>{[](int value) noexcept
+                                                 {
+                                                     return value * 2;
+                                                 }};
+    EXPECT_TRUE(noexcept(f(1)));
+    EXPECT_EQ(f(2), 4);
+    EXPECT_FALSE(noexcept(std::declval<inplace_function<int(int)>&>()(1)));
+    EXPECT_FALSE((std::is_constructible_v<inplace_function<int(int) noexcept>, int (*)(int)>));
+}
+
+TEST(Functional, InplaceFunctionNullPointer)
+{
+    struct Counter {
+        int value;
+        int get() const
+        {
+            return value;
+        }
+    };
+    auto nullFunction = static_cast<int (*)(int)>(nullptr);
+    EXPECT_FALSE(inplace_function<int(int)>{nullFunction});
+    auto nullMemberFunction = static_cast<int (Counter::*)() const>(nullptr);
+    EXPECT_FALSE((inplace_function<int(const Counter&)>{nullMemberFunction}));
+    auto nullMember = static_cast<int Counter::*>(nullptr);
+    EXPECT_FALSE((inplace_function<int(const Counter&)>{nullMember}));
+
+    auto member = inplace_function<int(const Counter&)>{&Counter::get};
+    ASSERT_TRUE(member);
+    EXPECT_EQ(member(Counter{7}), 7);
+    auto function = inplace_function<int(int)>{triple};
+    ASSERT_TRUE(function);
+    EXPECT_EQ(function(3), 9);
+}
+
+TEST(Functional, InplaceFunctionCapacity)
+{
+    auto f = inplace_function<int(), 64>{[data = std::array<int, 16>{1, 2, 3}]
+                                         {
+                                             return data[2];
+                                         }};
+    EXPECT_EQ(f(), 3);
+    EXPECT_FALSE((std::is_copy_constructible_v<inplace_function<int()>>));
+    EXPECT_TRUE((std::is_nothrow_move_constructible_v<inplace_function<int()>>));
+}
+
+TEST(Functional, VisitVariant)
+{
+    auto variant = std::variant<int, std::string, double>{std::string{"str"}};
+    auto visitor = overloaded{
+            [](int) -> std::string
+            {
+                return "int";
+            },
+            [](const std::string& value) -> std::string
+            {
+                return "string " + value;
+            },
+            [](double) -> std::string
+            {
+                return "double";
+            }};
+    EXPECT_EQ(sfun::visit(variant, visitor), "string str");
+    variant = 1;
+    EXPECT_EQ(sfun::visit(variant, visitor), "int");
+    variant = 1.0;
+    EXPECT_EQ(sfun::visit(variant, visitor), "double");
+}
+
+TEST(Functional, VisitVariantReference)
+{
+    auto variant = std::variant<int, std::string>{1};
+    sfun::visit(
+            variant,
+            overloaded{
+                    [](int& value)
+                    {
+                        value = 2;
+                    },
+                    [](std::string&) {}});
+    EXPECT_EQ(std::get<int>(variant), 2);
+
+    auto moved = std::variant<int, std::string>{std::string{"str"}};
+    auto result = sfun::visit(
+            std::move(moved),
+            overloaded{
+                    [](int&&)
+                    {
+                        return std::string{};
+                    },
+                    [](std::string&& value)
+                    {
+                        return std::move(value);
+                    }});
+    EXPECT_EQ(result, "str");
+}
+
+TEST(Functional, VisitMultipleVariants)
+{
+    auto lhs = std::variant<int, double>{1};
+    auto rhs = std::variant<int, double, std::string>{2.5};
+    auto visitor = overloaded{
+            [](int, int)
+            {
+                return 0;
+            },
+            [](int, double)
+            {
+                return 1;
+            },
+            [](double, int)
+            {
+                return 2;
+            },
+            [](double, double)
+            {
+                return 3;
+            },
+            [](auto, const std::string&)
+            {
+                return 4;
+            }};
+    EXPECT_EQ(sfun::visit(lhs, rhs, visitor), 1);
+    lhs = 1.0;
+    EXPECT_EQ(sfun::visit(lhs, rhs, visitor), 3);
+    rhs = 3;
+    EXPECT_EQ(sfun::visit(lhs, rhs, visitor), 2);
+    rhs = std::string{};
+    EXPECT_EQ(sfun::visit(lhs, rhs, visitor), 4);
+}
+
+namespace {
+template<std::size_t I>
+struct Alternative {
+    static constexpr auto value = I;
+};
+
+template<std::size_t... I>
+auto makeLargeVariant(std::index_sequence<I...>) -> std::variant<Alternative<I>...>;
+} //namespace
+
+TEST(Functional, VisitLargeVariant)
+{
+    using variant_t = decltype(makeLargeVariant(std::make_index_sequence<70>{}));
+    auto visitor = [](auto alternative)
+    {
+        return decltype(alternative)::value;
+    };
+    auto variant = variant_t{Alternative<20>{}};
+    EXPECT_EQ(sfun::visit(variant, visitor), 20u);
+    variant = Alternative<69>{};
+    EXPECT_EQ(sfun::visit(variant, visitor), 69u);
+
+    auto other = decltype(makeLargeVariant(std::make_index_sequence<30>{})){Alternative<29>{}};
+    EXPECT_EQ(sfun::visit(other, visitor), 29u);
+}
+
+TEST(Functional, VisitConstexpr)
+{
+    constexpr auto variant = std::variant<int, double>{2.5};
+    constexpr auto result = sfun::visit(
+            variant,
+            overloaded{
+                    [](int)
+                    {
+                        return 1;
+                    },
+                    [](double)
+                    {
+                        return 2;
+                    }});
+    static_assert(result == 2);
+}
+
+TEST(Functional, TryInvokeExpected)
+{
+    auto result = try_invoke_expected(
+            [](int value)
+            {
+                return value * 2;
+            },
+            2);
+    EXPECT_TRUE((std::is_same_v<decltype(result), expected<int, std::exception_ptr>>));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, 4);
+
+    auto error = try_invoke_expected(
+            []() -> int
+            {
+                throw std::runtime_error{"error"};
+            });
+    ASSERT_FALSE(error);
+    ASSERT_TRUE(error.error());
+    try {
+        std::rethrow_exception(error.error());
+    }
+    catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string{e.what()}, "error");
+    }
+}
+
+TEST(Functional, TryInvokeExpectedVoid)
+{
+    auto called = false;
+    auto result = try_invoke_expected(
+            [&called]
+            {
+                called = true;
+            });
+    EXPECT_TRUE((std::is_same_v<decltype(result), expected<void, std::exception_ptr>>));
+    EXPECT_TRUE(result);
+    EXPECT_TRUE(called);
+
+    auto error = try_invoke_expected(
+            []
+            {
+                throw std::runtime_error{"error"};
+            });
+    EXPECT_FALSE(error);
+}
+
+TEST(Functional, TryInvokeExpectedReference)
+{
+    auto str = std::string{"value"};
+    auto result = try_invoke_expected(
+            [&str]() noexcept -> std::string&
+            {
+                return str;
+            });
+    EXPECT_TRUE((std::is_same_v<decltype(result), expected<std::string&, std::exception_ptr>>));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(&*result, &str);
+
+    auto moved = try_invoke_expected(
+            [&str]() -> std::string&&
+            {
+                return std::move(str);
+            });
+    EXPECT_TRUE((std::is_same_v<decltype(moved), expected<std::string, std::exception_ptr>>));
+    EXPECT_EQ(*moved, "value");
+}
@@ -0,0 +1,137 @@
+#include <sfun/intrusive_ptr.h>
+#include <sfun/member.h>
+#include <sfun/type_traits.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sfun;
+
+namespace {
+
+int nodeCount = 0;
+
+struct Node : ref_counted<Node> {
+    explicit Node(std::string name)
+        : name{std::move(name)}
+    {
+        ++nodeCount;
+    }
+    Node(const Node& other)
+        : ref_counted<Node>{other}
+        , name{other.name}
+    {
+        ++nodeCount;
+    }
+    ~Node()
+    {
+        --nodeCount;
+    }
+
+    std::string name;
+    std::vector<intrusive_ptr<Node>> children;
+};
+
+struct LocalNode : ref_counted<LocalNode, ref_counting::single_threaded> {
+    int value = 0;
+};
+
+struct Graph {
+    indirect_member<intrusive_ptr<Node>> root;
+    indirect_member<intrusive_ptr<const Node>> constRoot;
+};
+
+static_assert(is_smart_pointer_v<intrusive_ptr<Node>>);
+static_assert(sizeof(intrusive_ptr<Node>) == sizeof(Node*));
+
+} //namespace
+
+TEST(IntrusivePtr, RefCount)
+{
+    nodeCount = 0;
+    {
+        auto node = make_intrusive<Node>("root");
+        EXPECT_EQ(node->ref_count(), 1);
+        auto copy = node;
+        EXPECT_EQ(node->ref_count(), 2);
+        EXPECT_EQ(copy, node);
+        auto moved = std::move(copy);
+        EXPECT_EQ(copy, nullptr);
+        EXPECT_EQ(node->ref_count(), 2);
+        moved.reset();
+        EXPECT_EQ(node->ref_count(), 1);
+        EXPECT_EQ((*node).name, "root");
+        EXPECT_EQ(nodeCount, 1);
+    }
+    EXPECT_EQ(nodeCount, 0);
+}
+
+TEST(IntrusivePtr, CopyDoesntCopyRefCount)
+{
+    nodeCount = 0;
+    {
+        auto node = make_intrusive<Node>("node");
+        auto other = node;
+        auto nodeCopy = make_intrusive<Node>(*node);
+        EXPECT_EQ(nodeCopy->ref_count(), 1);
+        EXPECT_EQ(nodeCopy->name, "node");
+        EXPECT_EQ(nodeCount, 2);
+    }
+    EXPECT_EQ(nodeCount, 0);
+}
+
+TEST(IntrusivePtr, Graph)
+{
+    nodeCount = 0;
+    {
+        auto root = make_intrusive<Node>("root");
+        auto child = make_intrusive<Node>("child");
+        root->children.push_back(child);
+        root->children.push_back(child);
+        EXPECT_EQ(child->ref_count(), 3);
+
+        auto graph = Graph{root, root};
+        EXPECT_EQ(graph.root->name, "root");
+        EXPECT_EQ((*graph.constRoot).children.size(), 2);
+        EXPECT_EQ(root->ref_count(), 3);
+        auto graphCopy = graph;
+        EXPECT_EQ(root->ref_count(), 5);
+    }
+    EXPECT_EQ(nodeCount, 0);
+}
+
+TEST(IntrusivePtr, SingleThreaded)
+{
+    auto node = make_intrusive<LocalNode>();
+    auto copy = node;
+    copy->value = 42;
+    EXPECT_EQ(node->value, 42);
+    EXPECT_EQ(node->ref_count(), 2);
+    auto detached = copy.detach();
+    EXPECT_FALSE(copy);
+    auto adopted = intrusive_ptr<LocalNode>{detached, false};
+    EXPECT_EQ(node->ref_count(), 2);
+}
+
+TEST(IntrusivePtr, ConcurrentCopies)
+{
+    nodeCount = 0;
+    {
+        auto node = make_intrusive<Node>("shared");
+        auto threads = std::vector<std::thread>{};
+        for (auto i = 0; i < 4; ++i)
+            threads.emplace_back(
+                    [node]
+                    {
+                        for (auto j = 0; j < 1000; ++j) {
+                            auto copy = node;
+                            auto copy2 = intrusive_ptr<const Node>{copy};
+                        }
+                    });
+        for (auto& thread : threads)
+            thread.join();
+        EXPECT_EQ(node->ref_count(), 1);
+    }
+    EXPECT_EQ(nodeCount, 0);
+}
@@ -0,0 +1,238 @@
+#include <sfun/lazy_member.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sfun;
+
+namespace {
+
+int factoryCallCount = 0;
+
+struct StringFactory {
+    std::string operator()() const
+    {
+        ++factoryCallCount;
+        return "Hello world";
+    }
+};
+
+struct ThrowingFactory {
+    int operator()() const
+    {
+        if (shouldThrow)
+            throw std::runtime_error{"error"};
+        return 42;
+    }
+    static inline bool shouldThrow = true;
+};
+
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
+template<lazy_init Init>
+struct ReentrantFactory {
+    int operator()() const
+    {
+        return self->get() + 1;
+    }
+    static inline const lazy_member<int, ReentrantFactory, Init>* self = nullptr;
+};
+
+struct ContractViolation {};
+
+void throwContractViolation(const char*, const char*, int)
+{
+    throw ContractViolation{};
+}
+#endif
+
+struct Foo {
+    lazy_member<std::string, StringFactory> str;
+    lazy_member<std::string, StringFactory, lazy_init::single_threaded> unsyncStr;
+};
+
+static_assert(sizeof(lazy_member<int, ThrowingFactory, lazy_init::single_threaded>) == 2 * sizeof(int));
+static_assert(sizeof(lazy_member<int, ThrowingFactory>) == 2 * sizeof(int));
+
+} //namespace
+
+TEST(LazyMember, InitOnFirstAccess)
+{
+    factoryCallCount = 0;
+    auto foo = Foo{};
+    EXPECT_FALSE(foo.str.is_initialized());
+    EXPECT_FALSE(foo.unsyncStr.is_initialized());
+    EXPECT_EQ(factoryCallCount, 0);
+
+    EXPECT_EQ(foo.str.get(), "Hello world");
+    EXPECT_EQ(foo.str->size(), 11);
+    EXPECT_EQ(*foo.str, "Hello world");
+    EXPECT_TRUE(foo.str.is_initialized());
+    EXPECT_EQ(factoryCallCount, 1);
+
+    const auto& unsyncStr = foo.unsyncStr;
+    const std::string& value = unsyncStr;
+    EXPECT_EQ(value, "Hello world");
+    EXPECT_TRUE(unsyncStr == "Hello world");
+    EXPECT_EQ(factoryCallCount, 2);
+}
+
+TEST(LazyMember, Modify)
+{
+    auto foo = Foo{};
+    foo.str.get() += "!";
+    std::string& value = foo.str;
+    value += "!";
+    EXPECT_EQ(foo.str, "Hello world!!");
+}
+
+TEST(LazyMember, CopyAndMove)
+{
+    factoryCallCount = 0;
+    auto foo = Foo{};
+    auto fooCopy = foo;
+    EXPECT_FALSE(fooCopy.str.is_initialized());
+
+    foo.str.get() = "Hello moon";
+    auto fooCopy2 = foo;
+    EXPECT_TRUE(fooCopy2.str.is_initialized());
+    EXPECT_EQ(fooCopy2.str, "Hello moon");
+
+    auto fooMoved = std::move(fooCopy2);
+    EXPECT_EQ(fooMoved.str, "Hello moon");
+
+    fooCopy = fooMoved;
+    EXPECT_EQ(fooCopy.str, "Hello moon");
+    EXPECT_EQ(factoryCallCount, 1);
+}
+
+TEST(LazyMember, FactoryLambda)
+{
+    auto factory = []
+    {
+        return std::vector<int>{1, 2, 3};
+    };
+    auto vec = lazy_member<std::vector<int>, decltype(factory)>{factory};
+    EXPECT_EQ(vec->size(), 3);
+    vec.reset();
+    EXPECT_FALSE(vec.is_initialized());
+    EXPECT_EQ(vec.get(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(LazyMember, FactoryThrows)
+{
+    auto value = lazy_member<int, ThrowingFactory>{};
+    ThrowingFactory::shouldThrow = true;
+    EXPECT_THROW(value.get(), std::runtime_error);
+    EXPECT_FALSE(value.is_initialized());
+    ThrowingFactory::shouldThrow = false;
+    EXPECT_EQ(value.get(), 42);
+}
+
+TEST(LazyMember, ConcurrentInit)
+{
+    auto callCount = std::atomic<int>{};
+    auto factory = [&callCount]
+    {
+        ++callCount;
+        std::this_thread::yield();
+        return std::string{"Hello world"};
+    };
+    for (auto attempt = 0; attempt < 50; ++attempt) {
+        auto str = lazy_member<std::string, decltype(factory)>{factory};
+        auto threads = std::vector<std::thread>{};
+        auto matchCount = std::atomic<int>{};
+        for (auto i = 0; i < 4; ++i)
+            threads.emplace_back(
+                    [&]
+                    {
+                        if (str.get() == "Hello world")
+                            ++matchCount;
+                    });
+        for (auto& thread : threads)
+            thread.join();
+        EXPECT_EQ(matchCount, 4);
+    }
+    EXPECT_EQ(callCount, 50);
+}
+
+TEST(LazyMember, ConcurrentLongInit)
+{
+    auto callCount = std::atomic<int>{};
+    auto factory = [&callCount]
+    {
+        ++callCount;
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        return std::string{"Hello world"};
+    };
+    auto str = lazy_member<std::string, decltype(factory)>{factory};
+    auto threads = std::vector<std::thread>{};
+    auto matchCount = std::atomic<int>{};
+    for (auto i = 0; i < 4; ++i)
+        threads.emplace_back(
+                [&]
+                {
+                    if (str.get() == "Hello world")
+                        ++matchCount;
+                });
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(matchCount, 4);
+    EXPECT_EQ(callCount, 1);
+}
+
+TEST(LazyMember, Operators)
+{
+    auto number = lazy_member<int, ThrowingFactory>{};
+    ThrowingFactory::shouldThrow = false;
+    EXPECT_TRUE(number == 42);
+    EXPECT_TRUE(number != 0);
+    EXPECT_TRUE(number < 43);
+    EXPECT_TRUE(number <= 42);
+    EXPECT_TRUE(number > 41);
+    EXPECT_TRUE(number >= 42);
+    EXPECT_TRUE(number);
+
+    auto vecFactory = []
+    {
+        return std::vector<int>{1, 2, 3};
+    };
+    auto vec = lazy_member<std::vector<int>, decltype(vecFactory)>{vecFactory};
+    EXPECT_EQ(vec[1], 2);
+    vec[1] = 4;
+    const auto& constVec = vec;
+    EXPECT_EQ(constVec[1], 4);
+
+    auto funcFactory = []
+    {
+        return std::function<int(int)>{[](int value)
+                                       {
+                                           return value * 2;
+                                       }};
+    };
+    auto func = lazy_member<std::function<int(int)>, decltype(funcFactory)>{funcFactory};
+    EXPECT_EQ(func(2), 4);
+}
+
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
+TEST(LazyMember, ReentrantInit)
+{
+    auto prevHandler = sfun::set_contract_violation_handler(throwContractViolation);
+
+    auto value = lazy_member<int, ReentrantFactory<lazy_init::thread_safe>>{};
+    ReentrantFactory<lazy_init::thread_safe>::self = &value;
+    EXPECT_THROW(value.get(), ContractViolation);
+    EXPECT_FALSE(value.is_initialized());
+
+    auto unsyncValue = lazy_member<int, ReentrantFactory<lazy_init::single_threaded>, lazy_init::single_threaded>{};
+    ReentrantFactory<lazy_init::single_threaded>::self = &unsyncValue;
+    EXPECT_THROW(unsyncValue.get(), ContractViolation);
+    EXPECT_FALSE(unsyncValue.is_initialized());
+
+    sfun::set_contract_violation_handler(prevHandler);
+}
+#endif
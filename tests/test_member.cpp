@@ -1,8 +1,12 @@
 #include <sfun/member.h>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace sfun;
 
@@ -465,4 +469,126 @@ TEST(Member, Constexpr)
     static_assert(t.func_ptr() == 777);
 }
 
+struct EmptyPolicy {
+    int operator()(int value) const
+    {
+        return value * 2;
+    }
+};
+
+struct FinalEmptyPolicy final {};
+
+struct NodeWithMember {
+    member<EmptyPolicy> policy;
+    int value;
+};
+
+struct NodeWithRawPolicy {
+    EmptyPolicy policy;
+    int value;
+};
+
+struct NodeWithPolicyBase : member<std::less<int>> {
+    int value;
+};
+
+static_assert(std::is_empty_v<member<EmptyPolicy>>);
+static_assert(std::is_empty_v<member<const EmptyPolicy>>);
+static_assert(!std::is_empty_v<member<FinalEmptyPolicy>>);
+static_assert(sizeof(member<EmptyPolicy>) == sizeof(EmptyPolicy));
+static_assert(sizeof(NodeWithMember) == sizeof(NodeWithRawPolicy));
+static_assert(sizeof(NodeWithPolicyBase) == sizeof(int));
+
+struct CharWithPolicyBase : member<EmptyPolicy> {
+    char value;
+};
+
+struct CharWithRawPolicy {
+    EmptyPolicy policy;
+    char value;
+};
+
+static_assert(sizeof(CharWithPolicyBase) == sizeof(char));
+static_assert(sizeof(CharWithPolicyBase) < sizeof(CharWithRawPolicy));
+static_assert(!std::is_convertible_v<member<EmptyPolicy>*, EmptyPolicy*>);
+
+TEST(Member, EmptyType)
+{
+    auto node = NodeWithMember{};
+    node.value = 21;
+    EXPECT_EQ(node.policy(node.value), 42);
+    const EmptyPolicy& policy = node.policy;
+    EXPECT_EQ(policy(1), 2);
+
+    auto constPolicy = member<const EmptyPolicy>{EmptyPolicy{}};
+    EXPECT_EQ(constPolicy.get()(2), 4);
+
+    auto base = NodeWithPolicyBase{};
+    EXPECT_TRUE(base.get()(1, 2));
+    auto copy = base;
+    EXPECT_FALSE(copy(2, 1));
+}
+
+int applyPolicy(const EmptyPolicy& policy, int value)
+{
+    return policy(value);
+}
+
+int compareWith(std::less<int> cmp)
+{
+    return cmp(1, 2);
+}
+
+TEST(Member, EmptyTypeConversion)
+{
+    const auto policy = member<EmptyPolicy>{};
+    EXPECT_EQ(applyPolicy(policy, 3), 6);
+    EXPECT_EQ(applyPolicy(member<EmptyPolicy>{}, 4), 8);
+    EXPECT_TRUE(compareWith(member<std::less<int>>{}));
+
+    auto base = NodeWithPolicyBase{};
+    const std::less<int>& cmp = base;
+    EXPECT_TRUE(cmp(1, 2));
+}
+
+struct Counters {
+    cache_aligned<int> first;
+    cache_aligned<int> second;
+};
+
+static_assert(alignof(cache_aligned<int>) == 64);
+static_assert(sizeof(cache_aligned<int>) == alignof(cache_aligned<int>));
+static_assert(sizeof(Counters) == 2 * sizeof(cache_aligned<int>));
+
+TEST(Member, CacheAligned)
+{
+    auto counters = Counters{};
+    counters.first = 1;
+    ++counters.second;
+    counters.second += 2;
+    EXPECT_EQ(counters.first, 1);
+    EXPECT_EQ(counters.second.get(), 3);
+    EXPECT_NE(
+            reinterpret_cast<std::uintptr_t>(&counters.first) / alignof(cache_aligned<int>),
+            reinterpret_cast<std::uintptr_t>(&counters.second) / alignof(cache_aligned<int>));
+
+    auto str = cache_aligned<std::string>{"Hello"};
+    auto strCopy = str;
+    EXPECT_EQ(strCopy.get(), "Hello");
+    EXPECT_EQ(strCopy.get().size(), 5);
+
+    auto counter = cache_aligned<std::atomic<int>>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 4; ++i)
+        threads.emplace_back(
+                [&counter]
+                {
+                    for (auto j = 0; j < 1000; ++j)
+                        counter.get().fetch_add(1);
+                });
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(counter.get(), 4000);
+}
+
 } //namespace
\ No newline at end of file
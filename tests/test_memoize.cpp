@@ -0,0 +1,171 @@
+#include <sfun/memoize.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sfun;
+
+TEST(Memoize, CachesResults)
+{
+    auto callCount = 0;
+    auto square = memoize(
+            [&callCount](int value)
+            {
+                ++callCount;
+                return value * value;
+            });
+    EXPECT_EQ(square(3), 9);
+    EXPECT_EQ(square(3), 9);
+    EXPECT_EQ(square(4), 16);
+    EXPECT_EQ(callCount, 2);
+    EXPECT_EQ(square.size(), 2u);
+
+    auto stats = square.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 2u);
+
+    square.clear();
+    EXPECT_EQ(square.size(), 0u);
+    EXPECT_EQ(square(3), 9);
+    EXPECT_EQ(callCount, 3);
+}
+
+TEST(Memoize, DecaysArguments)
+{
+    auto concat = memoize(
+            [](const std::string& lhs, const std::string& rhs)
+            {
+                return lhs + rhs;
+            });
+    EXPECT_TRUE((std::is_same_v<decltype(concat)::key_type, std::tuple<std::string, std::string>>));
+    auto lhs = std::string{"a"};
+    EXPECT_EQ(concat(lhs, "b"), "ab");
+    lhs = "c";
+    EXPECT_EQ(concat(lhs, "b"), "cb");
+    EXPECT_EQ(concat("a", "b"), "ab");
+    EXPECT_EQ(concat.stats().hits, 1u);
+}
+
+int triple(int value)
+{
+    return value * 3;
+}
+
+TEST(Memoize, FunctionPointer)
+{
+    auto memoizedTriple = memoize(&triple);
+    EXPECT_EQ(memoizedTriple(2), 6);
+    EXPECT_EQ(memoizedTriple(2), 6);
+    EXPECT_EQ(memoizedTriple.stats().hits, 1u);
+}
+
+TEST(Memoize, CapacityEviction)
+{
+    auto callCount = 0;
+    auto identity = memoize(
+            [&callCount](int value)
+            {
+                ++callCount;
+                return value;
+            },
+            memoize_options{2, 1});
+    identity(1);
+    identity(2);
+    identity(1);
+    // 1 was referenced after insertion, so 2 is evicted
+    identity(3);
+    EXPECT_EQ(identity.size(), 2u);
+    EXPECT_EQ(callCount, 3);
+    identity(1);
+    EXPECT_EQ(callCount, 3);
+    identity(2);
+    EXPECT_EQ(callCount, 4);
+    EXPECT_EQ(identity.size(), 2u);
+}
+
+TEST(Memoize, CapacityBoundWithDefaultShards)
+{
+    for (auto capacity : {std::size_t{1}, std::size_t{10}, std::size_t{40}}) {
+        auto identity = memoize(
+                [](int value)
+                {
+                    return value;
+                },
+                memoize_options{capacity});
+        for (auto i = 0; i < 1000; ++i)
+            identity(i);
+        EXPECT_EQ(identity.size(), capacity);
+    }
+}
+
+TEST(Memoize, Concurrent)
+{
+    auto callCount = std::atomic<int>{};
+    auto square = memoize(
+            [&callCount](int value)
+            {
+                callCount.fetch_add(1);
+                return value * value;
+            },
+            memoize_options{64});
+    auto threads = std::vector<std::thread>{};
+    auto failed = std::atomic<bool>{};
+    for (auto i = 0; i < 8; ++i)
+        threads.emplace_back(
+                [&]
+                {
+                    for (auto j = 0; j < 1000; ++j) {
+                        auto value = j % 100;
+                        if (square(value) != value * value)
+                            failed = true;
+                    }
+                });
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_FALSE(failed);
+    EXPECT_LE(square.size(), 64u);
+    auto stats = square.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 8000u);
+}
+
+TEST(Memoize, ConcurrentEvictionAndClear)
+{
+    auto describe = memoize(
+            [](int value)
+            {
+                return std::string(static_cast<std::size_t>(value % 50), 'x') + std::to_string(value);
+            },
+            memoize_options{32, 4});
+    auto stop = std::atomic<bool>{};
+    auto failed = std::atomic<bool>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 8; ++i)
+        threads.emplace_back(
+                [&, i]
+                {
+                    for (auto j = 0; j < 2000; ++j) {
+                        auto value = (i * 7 + j) % 300;
+                        if (describe(value) != std::string(static_cast<std::size_t>(value % 50), 'x') +
+                                    std::to_string(value))
+                            failed = true;
+                    }
+                });
+    threads.emplace_back(
+            [&]
+            {
+                while (!stop) {
+                    describe.clear();
+                    std::this_thread::yield();
+                }
+            });
+    for (auto i = 0; i < 8; ++i)
+        threads[static_cast<std::size_t>(i)].join();
+    stop = true;
+    threads.back().join();
+    EXPECT_FALSE(failed);
+    EXPECT_LE(describe.size(), 32u);
+    auto stats = describe.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 16000u);
+}
@@ -0,0 +1,78 @@
+#include <sfun/packed_tuple.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+
+using namespace sfun;
+
+TEST(PackedTuple, Size)
+{
+    using tuple = packed_tuple<char, double, char, std::int32_t, char, std::int16_t>;
+    EXPECT_EQ(tuple::size(), 6u);
+    EXPECT_EQ(sizeof(tuple), 24u);
+    EXPECT_LT(sizeof(tuple), sizeof(std::tuple<char, double, char, std::int32_t, char, std::int16_t>));
+    EXPECT_EQ(sizeof(packed_tuple<char, std::int64_t, char>), 16u);
+}
+
+TEST(PackedTuple, StoragePosition)
+{
+    using tuple = packed_tuple<char, double, std::int16_t, std::int32_t, char>;
+    EXPECT_EQ(tuple::storage_position<0>(), 3u);
+    EXPECT_EQ(tuple::storage_position<1>(), 0u);
+    EXPECT_EQ(tuple::storage_position<2>(), 2u);
+    EXPECT_EQ(tuple::storage_position<3>(), 1u);
+    EXPECT_EQ(tuple::storage_position<4>(), 4u);
+}
+
+TEST(PackedTuple, Get)
+{
+    auto tuple = packed_tuple<char, double, std::string, int>{'a', 1.5, "str", 42};
+    EXPECT_EQ(get<0>(tuple), 'a');
+    EXPECT_EQ(get<1>(tuple), 1.5);
+    EXPECT_EQ(get<2>(tuple), "str");
+    EXPECT_EQ(get<3>(tuple), 42);
+
+    get<3>(tuple) = 7;
+    EXPECT_EQ(get<3>(tuple), 7);
+
+    const auto& constTuple = tuple;
+    EXPECT_TRUE((std::is_same_v<decltype(get<2>(constTuple)), const std::string&>));
+    EXPECT_TRUE((std::is_same_v<decltype(get<2>(std::move(tuple))), std::string&&>));
+}
+
+TEST(PackedTuple, DefaultConstruction)
+{
+    auto tuple = packed_tuple<char, double, int>{};
+    EXPECT_EQ(get<0>(tuple), '\0');
+    EXPECT_EQ(get<1>(tuple), 0.0);
+    EXPECT_EQ(get<2>(tuple), 0);
+}
+
+TEST(PackedTuple, MoveOnly)
+{
+    auto tuple = packed_tuple<char, std::unique_ptr<int>>{'a', std::make_unique<int>(42)};
+    auto other = std::move(tuple);
+    ASSERT_TRUE(get<1>(other));
+    EXPECT_EQ(*get<1>(other), 42);
+    EXPECT_FALSE(get<1>(tuple));
+}
+
+TEST(PackedTuple, StructuredBinding)
+{
+    auto tuple = packed_tuple<char, double, int>{'a', 1.5, 42};
+    auto& [ch, number, integer] = tuple;
+    EXPECT_EQ(ch, 'a');
+    EXPECT_EQ(number, 1.5);
+    EXPECT_EQ(integer, 42);
+    EXPECT_TRUE((std::is_same_v<std::tuple_element_t<1, decltype(tuple)>, double>));
+}
+
+TEST(PackedTuple, Constexpr)
+{
+    constexpr auto tuple = packed_tuple<char, double, int>{'a', 1.5, 42};
+    static_assert(get<0>(tuple) == 'a');
+    static_assert(get<1>(tuple) == 1.5);
+    static_assert(get<2>(tuple) == 42);
+}
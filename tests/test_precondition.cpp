@@ -1,6 +1,9 @@
 #include <sfun/precondition.h>
 #include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <string>
 #include <vector>
@@ -16,6 +19,7 @@ TEST(Precondition, NotEmpty)
     ASSERT_EQ(dataSize(data), 3);
 }
 
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
 TEST(Precondition, NotEmptyViolated)
 {
     auto dataSize = [](sfun::not_empty<const std::vector<int>&> data)
@@ -36,6 +40,7 @@ TEST(Precondition, NotEmptyViolated)
             ::testing::ExitedWithCode(1),
             ".*");
 }
+#endif
 
 struct Foo {
     int num = 42;
@@ -52,6 +57,7 @@ TEST(Precondition, Valid)
     ASSERT_EQ(getNum(&foo), 42);
 }
 
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
 TEST(Precondition, ValidViolated)
 {
     auto getNum = [](sfun::valid<const Foo*> pFoo)
@@ -72,6 +78,7 @@ TEST(Precondition, ValidViolated)
             ::testing::ExitedWithCode(1),
             ".*");
 }
+#endif
 
 TEST(Precondition, Interval)
 {
@@ -84,6 +91,7 @@ TEST(Precondition, Interval)
     ASSERT_EQ(getNum(127), 1127);
 }
 
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
 TEST(Precondition, IntervalViolated)
 {
     auto getNum = [](sfun::interval<int, 0, 128> num)
@@ -102,8 +110,9 @@ TEST(Precondition, IntervalViolated)
                 exit(0);
             },
             ::testing::ExitedWithCode(1),
-            ".*");
+            "contract violation: x >= lowerBound && x < upperBound");
 }
+#endif
 
 TEST(Precondition, IntervalOpen)
 {
@@ -115,6 +124,7 @@ TEST(Precondition, IntervalOpen)
     ASSERT_EQ(getNum(127), 1127);
 }
 
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
 TEST(Precondition, IntervalOpenViolated)
 {
     auto getNum = [](sfun::interval_open<int, 0, 128> num)
@@ -135,6 +145,7 @@ TEST(Precondition, IntervalOpenViolated)
             ::testing::ExitedWithCode(1),
             ".*");
 }
+#endif
 
 TEST(Precondition, IntervalClosed)
 {
@@ -147,6 +158,7 @@ TEST(Precondition, IntervalClosed)
     ASSERT_EQ(getNum(128), 1128);
 }
 
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
 TEST(Precondition, IntervalClosedViolated)
 {
     auto getNum = [](sfun::interval_closed<int, 0, 128> num)
@@ -167,6 +179,7 @@ TEST(Precondition, IntervalClosedViolated)
             ::testing::ExitedWithCode(1),
             ".*");
 }
+#endif
 
 TEST(Precondition, NotNegative)
 {
@@ -178,6 +191,7 @@ TEST(Precondition, NotNegative)
     ASSERT_EQ(getNum(127), 1127);
 }
 
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
 TEST(Precondition, NotNegativeViolated)
 {
     auto getNum = [](sfun::not_negative<float> num)
@@ -197,4 +211,224 @@ TEST(Precondition, NotNegativeViolated)
             },
             ::testing::ExitedWithCode(1),
             ".*");
-}
\ No newline at end of file
+}
+#endif
+namespace {
+
+struct Pipeline {
+    sfun::refined_not_empty<std::vector<int>> data;
+    sfun::refined_interval<int, 0, 10> index;
+};
+
+std::size_t dataSize(sfun::refined_not_empty<std::vector<int>> data)
+{
+    return data.get().size();
+}
+
+int nextStage(sfun::refined_interval_closed<int, 0, 100> num)
+{
+    return num;
+}
+
+int lastStage(sfun::refined_not_negative<int> num)
+{
+    return num;
+}
+
+} //namespace
+
+static_assert(std::is_copy_constructible_v<sfun::refined_not_empty<std::vector<int>>>);
+static_assert(std::is_move_constructible_v<sfun::refined_not_empty<std::vector<int>>>);
+static_assert(std::is_convertible_v<sfun::refined_interval<int, 0, 10>, sfun::refined_interval<int, 0, 100>>);
+static_assert(std::is_convertible_v<sfun::refined_interval<int, 0, 101>, sfun::refined_interval_closed<int, 0, 100>>);
+static_assert(!std::is_convertible_v<sfun::refined_interval<int, 0, 102>, sfun::refined_interval_closed<int, 0, 100>>);
+static_assert(!std::is_convertible_v<sfun::refined_interval<int, -1, 10>, sfun::refined_interval<int, 0, 100>>);
+static_assert(std::is_convertible_v<sfun::refined_interval_open<int, -1, 10>, sfun::refined_not_negative<int>>);
+static_assert(!std::is_convertible_v<sfun::refined_interval<int, -1, 10>, sfun::refined_not_negative<int>>);
+static_assert(!std::is_convertible_v<sfun::refined_not_negative<int>, sfun::refined_interval<int, 0, 100>>);
+
+TEST(Precondition, Refined)
+{
+    auto pipeline = Pipeline{std::vector{1, 2, 3}, 5};
+    auto pipelineCopy = pipeline;
+    EXPECT_EQ(pipelineCopy.data.get(), (std::vector{1, 2, 3}));
+    EXPECT_EQ(pipelineCopy.index, 5);
+
+    auto index = pipeline.index;
+    EXPECT_EQ(nextStage(index), 5);
+    EXPECT_EQ(lastStage(index), 5);
+    EXPECT_EQ(nextStage(42), 42);
+
+    EXPECT_EQ(dataSize(pipeline.data), 3);
+    auto data = std::move(pipeline.data).get();
+    EXPECT_EQ(data.size(), 3);
+}
+
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
+TEST(Precondition, RefinedViolated)
+{
+    ASSERT_EXIT(
+            {
+                std::set_terminate(
+                        []
+                        {
+                            exit(1);
+                        });
+                dataSize(std::vector<int>{});
+                exit(0);
+            },
+            ::testing::ExitedWithCode(1),
+            ".*");
+}
+#endif
+
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
+TEST(Precondition, RefinedIntervalViolated)
+{
+    ASSERT_EXIT(
+            {
+                std::set_terminate(
+                        []
+                        {
+                            exit(1);
+                        });
+                nextStage(101);
+                exit(0);
+            },
+            ::testing::ExitedWithCode(1),
+            ".*");
+}
+#endif
+
+TEST(Precondition, IntervalFloatingPoint)
+{
+    auto getNum = [](sfun::interval_closed<double, -1, 1> num)
+    {
+        return num * 2;
+    };
+    ASSERT_EQ(getNum(-1.0), -2.0);
+    ASSERT_EQ(getNum(0.25), 0.5);
+}
+
+static_assert(sfun::detail::isRepresentableBound<float, 16777216>());
+static_assert(!sfun::detail::isRepresentableBound<float, 16777217>());
+static_assert(!sfun::detail::isRepresentableBound<unsigned, -1>());
+static_assert(!sfun::detail::isRepresentableBound<int, 3000000000LL>());
+static_assert(sfun::detail::isRepresentableBound<long long, 3000000000LL>());
+static_assert(!sfun::detail::isRepresentableBound<std::uint8_t, 256>());
+
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
+TEST(Precondition, IntervalFloatingPointViolated)
+{
+    auto getNum = [](sfun::interval<float, 0, 1> num)
+    {
+        return num * 2;
+    };
+
+    ASSERT_EXIT(
+            {
+                std::set_terminate(
+                        []
+                        {
+                            exit(1);
+                        });
+                getNum(1.f);
+                exit(0);
+            },
+            ::testing::ExitedWithCode(1),
+            "contract violation: x >= lowerBound && x < upperBound");
+}
+#endif
+
+static_assert(std::is_convertible_v<sfun::refined_interval_open<float, 0, 1>, sfun::refined_interval<float, 0, 1>>);
+static_assert(!std::is_convertible_v<sfun::refined_interval<float, 0, 1>, sfun::refined_interval_open<float, 0, 1>>);
+static_assert(std::is_convertible_v<sfun::refined_interval<float, 0, 1>, sfun::refined_interval_closed<float, 0, 1>>);
+static_assert(std::is_convertible_v<sfun::refined_interval_open<float, 0, 1>, sfun::refined_not_negative<float>>);
+static_assert(
+        std::is_convertible_v<sfun::checked_span_interval<int, 0, 10>, sfun::checked_span_interval<int, -10, 10>>);
+static_assert(!std::is_convertible_v<sfun::checked_span_interval<int, 0, 10>, sfun::checked_span_interval<int, 1, 10>>);
+static_assert(std::is_constructible_v<sfun::checked_span_interval<int, 0, 10>, std::vector<int>&>);
+static_assert(std::is_constructible_v<sfun::checked_span_interval<int, 0, 10>, const std::vector<int>&>);
+static_assert(!std::is_constructible_v<sfun::checked_span_interval<int, 0, 10>, std::vector<int>&&>);
+static_assert(!std::is_constructible_v<sfun::checked_span_not_negative<int>, std::array<int, 3>&&>);
+static_assert(!std::is_convertible_v<std::vector<int>&&, sfun::checked_span_interval<int, 0, 10>>);
+
+TEST(Precondition, AllInInterval)
+{
+    auto values = std::vector<float>(1000, 0.5f);
+    auto valuesSpan = sfun::span<const float>{values.data(), values.size()};
+    EXPECT_TRUE((sfun::all_in_interval<float, 0, 1>(valuesSpan)));
+    EXPECT_TRUE((sfun::all_in_interval_open<float, 0, 1>(valuesSpan)));
+    EXPECT_TRUE(sfun::all_not_negative(valuesSpan));
+    EXPECT_TRUE((sfun::all_in_interval<float, 0, 1>(sfun::span<const float>{})));
+
+    values[777] = 1.f;
+    EXPECT_FALSE((sfun::all_in_interval<float, 0, 1>(valuesSpan)));
+    EXPECT_TRUE((sfun::all_in_interval_closed<float, 0, 1>(valuesSpan)));
+    values[999] = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_FALSE((sfun::all_in_interval_closed<float, 0, 1>(valuesSpan)));
+    EXPECT_FALSE(sfun::all_not_negative(valuesSpan));
+
+    auto ints = std::vector<int>{0, 1, 2, -1};
+    EXPECT_FALSE(sfun::all_not_negative(sfun::span<const int>{ints.data(), ints.size()}));
+    EXPECT_TRUE((sfun::all_in_interval<int, -1, 3>(sfun::span<const int>{ints.data(), ints.size()})));
+}
+
+TEST(Precondition, AllInIntervalContainers)
+{
+    auto values = std::vector<float>{0.f, 0.5f, 0.75f};
+    EXPECT_TRUE((sfun::all_in_interval<float, 0, 1>(values)));
+    EXPECT_FALSE((sfun::all_in_interval_open<float, 0, 1>(values)));
+    EXPECT_TRUE(sfun::all_not_negative(values));
+
+    const auto array = std::array<int, 3>{1, 2, -3};
+    EXPECT_FALSE((sfun::all_in_interval<int, 0, 10>(array)));
+    EXPECT_FALSE(sfun::all_not_negative(array));
+
+    int cArray[] = {1, 2, 3};
+    EXPECT_TRUE((sfun::all_in_interval_closed<int, 1, 3>(cArray)));
+    EXPECT_TRUE(sfun::all_not_negative(cArray));
+}
+
+namespace {
+
+float sum(sfun::checked_span_interval_closed<float, -1, 1> values)
+{
+    auto result = 0.f;
+    for (auto i = std::size_t{}; i < values.get().size(); ++i)
+        result += values.get().data()[i];
+    return result;
+}
+
+} //namespace
+
+TEST(Precondition, CheckedSpan)
+{
+    auto values = std::vector<float>{0.5f, 0.25f, 1.f};
+    auto checkedValues = sfun::checked_span_interval<float, 0, 1>{values.data(), 2};
+    EXPECT_EQ(checkedValues.get().size(), 2);
+    EXPECT_EQ(sum(sfun::span<const float>{values.data(), values.size()}), 1.75f);
+
+    auto checkedVector = sfun::checked_span_interval_closed<float, 0, 1>{values};
+    EXPECT_EQ(checkedVector.get().size(), 3);
+    EXPECT_EQ(sum(values), 1.75f);
+}
+
+#if SFUN_CONTRACT_LEVEL != SFUN_CONTRACT_LEVEL_OFF
+TEST(Precondition, CheckedSpanViolated)
+{
+    ASSERT_EXIT(
+            {
+                std::set_terminate(
+                        []
+                        {
+                            exit(1);
+                        });
+                auto values = std::vector<float>(10, 2.f);
+                sum(sfun::span<const float>{values.data(), values.size()});
+                exit(0);
+            },
+            ::testing::ExitedWithCode(1),
+            ".*");
+}
+#endif
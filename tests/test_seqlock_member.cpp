@@ -0,0 +1,128 @@
+#include <sfun/seqlock_member.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace sfun;
+
+namespace {
+
+struct Config {
+    int first = 0;
+    int second = 0;
+    double third = 0;
+    char name[13] = {};
+};
+
+} //namespace
+
+TEST(SeqlockMember, LoadStore)
+{
+    auto value = seqlock_member<int>{};
+    EXPECT_EQ(value.load(), 0);
+    value = 42;
+    EXPECT_EQ(value.get(), 42);
+    value.store(7);
+    int copy = value;
+    EXPECT_EQ(copy, 7);
+
+    auto valueCopy = value;
+    EXPECT_EQ(valueCopy.load(), 7);
+    value.update(
+            [](int& x)
+            {
+                x *= 2;
+            });
+    EXPECT_EQ(value.load(), 14);
+    valueCopy = value;
+    EXPECT_EQ(valueCopy.load(), 14);
+}
+
+TEST(SeqlockMember, Struct)
+{
+    auto config = seqlock_member<Config>{Config{1, 2, 3.0, "config"}};
+    auto value = config.load();
+    EXPECT_EQ(value.first, 1);
+    EXPECT_EQ(value.second, 2);
+    EXPECT_EQ(value.third, 3.0);
+    EXPECT_STREQ(value.name, "config");
+}
+
+TEST(SeqlockMember, UpdateThrows)
+{
+    auto value = seqlock_member<int>{1};
+    EXPECT_THROW(
+            value.update(
+                    [](int& x)
+                    {
+                        x = 2;
+                        throw std::runtime_error{"error"};
+                    }),
+            std::runtime_error);
+    EXPECT_EQ(value.load(), 1);
+    value.store(3);
+    EXPECT_EQ(value.load(), 3);
+}
+
+TEST(SeqlockMember, ConcurrentUpdates)
+{
+    auto counter = seqlock_member<int>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 4; ++i)
+        threads.emplace_back(
+                [&counter]
+                {
+                    for (auto j = 0; j < 1000; ++j)
+                        counter.update(
+                                [](int& x)
+                                {
+                                    ++x;
+                                });
+                });
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(counter.load(), 4000);
+}
+
+TEST(SeqlockMember, ConcurrentReadsAreConsistent)
+{
+    auto config = seqlock_member<Config>{};
+    auto isStopped = std::atomic<bool>{};
+    auto inconsistentReadCount = std::atomic<int>{};
+    auto readers = std::vector<std::thread>{};
+    for (auto i = 0; i < 3; ++i)
+        readers.emplace_back(
+                [&]
+                {
+                    while (!isStopped) {
+                        auto value = config.load();
+                        if (value.second != value.first * 2 || value.third != value.first)
+                            ++inconsistentReadCount;
+                    }
+                });
+
+    auto writers = std::vector<std::thread>{};
+    for (auto i = 0; i < 2; ++i)
+        writers.emplace_back(
+                [&config]
+                {
+                    for (auto j = 0; j < 10000; ++j)
+                        config.update(
+                                [](Config& value)
+                                {
+                                    ++value.first;
+                                    value.second = value.first * 2;
+                                    value.third = value.first;
+                                });
+                });
+    for (auto& writer : writers)
+        writer.join();
+    isStopped = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(inconsistentReadCount, 0);
+    EXPECT_EQ(config.load().first, 20000);
+}
@@ -0,0 +1,237 @@
+#include <sfun/signal.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+thread_local auto heapCallCount = std::size_t{};
+} //namespace
+
+// GCC pairs the inlined std::free below with the new-expressions that call this operator new
+// and reports them as mismatched, although both sides of the pair are replaced here.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    ++heapCallCount;
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    ++heapCallCount;
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    ++heapCallCount;
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+using namespace sfun;
+
+TEST(Signal, Emit)
+{
+    auto sig = sfun::signal<const std::string&, int>{};
+    auto result = std::string{};
+    sig.connect(
+            [&result](const std::string& str, int count)
+            {
+                for (auto i = 0; i < count; ++i)
+                    result += str;
+            });
+    sig.connect(
+            [&result](const std::string&, int)
+            {
+                result += "!";
+            });
+    EXPECT_EQ(sig.size(), 2u);
+    sig.emit("a", 2);
+    EXPECT_EQ(result, "aa!");
+    sig("b", 1);
+    EXPECT_EQ(result, "aa!b!");
+}
+
+TEST(Signal, EmitWithoutSlots)
+{
+    auto sig = sfun::signal<int>{};
+    EXPECT_EQ(sig.size(), 0u);
+    sig.emit(1);
+}
+
+TEST(Signal, Disconnect)
+{
+    auto sig = sfun::signal<int>{};
+    auto sum = 0;
+    auto first = sig.connect(
+            [&sum](int value)
+            {
+                sum += value;
+            });
+    auto second = sig.connect(
+            [&sum](int value)
+            {
+                sum += value * 10;
+            });
+    EXPECT_NE(first, second);
+    sig.emit(1);
+    EXPECT_EQ(sum, 11);
+
+    EXPECT_TRUE(sig.disconnect(first));
+    EXPECT_FALSE(sig.disconnect(first));
+    sig.emit(1);
+    EXPECT_EQ(sum, 21);
+
+    sig.disconnect_all();
+    EXPECT_EQ(sig.size(), 0u);
+    sig.emit(1);
+    EXPECT_EQ(sum, 21);
+}
+
+TEST(Signal, DisconnectDuringEmit)
+{
+    auto sig = sfun::signal<>{};
+    auto callCount = 0;
+    auto connection = signal_connection{};
+    connection = sig.connect(
+            [&]
+            {
+                ++callCount;
+                sig.disconnect(connection);
+            });
+    sig.emit();
+    sig.emit();
+    EXPECT_EQ(callCount, 1);
+}
+
+TEST(Signal, ConcurrentEmitAndConnect)
+{
+    auto sig = sfun::signal<int>{};
+    auto sum = std::atomic<long>{};
+    auto stop = std::atomic<bool>{};
+    auto emitters = std::vector<std::thread>{};
+    for (auto i = 0; i < 4; ++i)
+        emitters.emplace_back(
+                [&]
+                {
+                    while (!stop)
+                        sig.emit(1);
+                });
+
+    auto connections = std::vector<signal_connection>{};
+    for (auto i = 0; i < 100; ++i) {
+        connections.push_back(sig.connect(
+                [&sum](int value)
+                {
+                    sum += value;
+                }));
+        if (i % 2)
+            sig.disconnect(connections[static_cast<std::size_t>(i / 2)]);
+    }
+    while (sum == 0)
+        std::this_thread::yield();
+    stop = true;
+    for (auto& thread : emitters)
+        thread.join();
+    EXPECT_EQ(sig.size(), 50u);
+}
+
+TEST(Signal, DisconnectedSlotsAreReleasedDuringEmission)
+{
+    auto sig = sfun::signal<int>{};
+    // A slow slot keeps the emissions of different threads overlapping, so there's always one in progress
+    auto emitCount = std::atomic<int>{};
+    sig.connect(
+            [&emitCount](int)
+            {
+                ++emitCount;
+                std::this_thread::sleep_for(std::chrono::microseconds{200});
+            });
+    auto stop = std::atomic<bool>{};
+    auto emitters = std::vector<std::thread>{};
+    for (auto i = 0; i < 4; ++i)
+        emitters.emplace_back(
+                [&]
+                {
+                    while (!stop)
+                        sig.emit(1);
+                });
+    while (emitCount < 8)
+        std::this_thread::yield();
+
+    auto sum = std::make_shared<std::atomic<long>>();
+    for (auto i = 0; i < 2000; ++i)
+        sig.disconnect(sig.connect(
+                [sum](int value)
+                {
+                    *sum += value;
+                }));
+
+    // The captures of the disconnected slots must be destroyed by the following connection changes,
+    // without waiting for the emissions to stop
+    const auto unknownConnection = signal_connection{~std::size_t{}};
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (sum.use_count() > 1 && std::chrono::steady_clock::now() < deadline) {
+        EXPECT_FALSE(sig.disconnect(unknownConnection));
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(sum.use_count(), 1);
+
+    stop = true;
+    for (auto& thread : emitters)
+        thread.join();
+    EXPECT_EQ(sig.size(), 1u);
+}
+
+TEST(Signal, EmitDoesntAllocate)
+{
+    auto sig = sfun::signal<int>{};
+    auto sum = std::atomic<long>{};
+    sig.connect(
+            [&sum](int value)
+            {
+                sum += value;
+            });
+    auto stop = std::atomic<bool>{};
+    auto emitHeapCallCount = std::atomic<std::size_t>{};
+    auto emitter = std::thread{[&]
+                               {
+                                   // warm up the thread's stripe index
+                                   sig.emit(0);
+                                   heapCallCount = 0;
+                                   while (!stop)
+                                       sig.emit(1);
+                                   emitHeapCallCount = heapCallCount;
+                               }};
+
+    // Connection changes retire the slot lists, which must be deleted outside of emission
+    while (sum < 100)
+        std::this_thread::yield();
+    for (auto i = 0; i < 1000; ++i) {
+        sig.disconnect(sig.connect(
+                [&sum](int value)
+                {
+                    sum += value;
+                }));
+        std::this_thread::yield();
+    }
+    stop = true;
+    emitter.join();
+    EXPECT_EQ(emitHeapCallCount, 0u);
+}
@@ -0,0 +1,102 @@
+#include <sfun/soa_vector.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+using namespace sfun;
+
+namespace {
+
+struct ThrowOnCopy {
+    ThrowOnCopy() = default;
+    ThrowOnCopy(const ThrowOnCopy&)
+    {
+        throw std::runtime_error{"copy"};
+    }
+    ThrowOnCopy(ThrowOnCopy&&) noexcept = default;
+};
+
+} //namespace
+
+TEST(SoaVector, EmplaceBack)
+{
+    auto vec = soa_vector<type_list<int, std::string, double>>{};
+    EXPECT_TRUE(vec.empty());
+    vec.emplace_back(1, "one", 1.5);
+    vec.emplace_back(2, std::string{"two"}, 2.5);
+    ASSERT_EQ(vec.size(), 2u);
+    EXPECT_FALSE(vec.empty());
+    EXPECT_EQ(vec[0], (std::tuple<int, std::string, double>{1, "one", 1.5}));
+    EXPECT_EQ(vec[1], (std::tuple<int, std::string, double>{2, "two", 2.5}));
+}
+
+TEST(SoaVector, PushBack)
+{
+    auto vec = soa_vector<type_list<int, std::string>>{};
+    auto row = std::tuple{1, std::string{"one"}};
+    vec.push_back(row);
+    vec.push_back({2, "two"});
+    ASSERT_EQ(vec.size(), 2u);
+    EXPECT_EQ(std::get<1>(vec[0]), "one");
+    EXPECT_EQ(std::get<1>(vec[1]), "two");
+}
+
+TEST(SoaVector, RowReference)
+{
+    auto vec = soa_vector<type_list<int, std::string>>{};
+    vec.emplace_back(1, "one");
+    auto [number, name] = vec[0];
+    number = 10;
+    name = "ten";
+    EXPECT_EQ(std::get<0>(vec[0]), 10);
+    EXPECT_EQ(std::get<1>(vec[0]), "ten");
+
+    const auto& constVec = vec;
+    EXPECT_TRUE((std::is_same_v<decltype(constVec[0]), std::tuple<const int&, const std::string&>>));
+}
+
+TEST(SoaVector, Column)
+{
+    auto vec = soa_vector<type_list<int, double>>{};
+    vec.reserve(3);
+    vec.emplace_back(1, 0.5);
+    vec.emplace_back(2, 1.5);
+    vec.emplace_back(3, 2.5);
+
+    auto ints = vec.column<0>();
+    ASSERT_EQ(ints.size(), 3u);
+    EXPECT_EQ(std::accumulate(ints.begin(), ints.end(), 0), 6);
+    for (auto& value : ints)
+        value *= 2;
+    EXPECT_EQ(std::get<0>(vec[2]), 6);
+
+    const auto& constVec = vec;
+    auto doubles = constVec.column<double>();
+    EXPECT_TRUE((std::is_same_v<decltype(doubles), span<const double>>));
+    EXPECT_EQ(std::accumulate(doubles.begin(), doubles.end(), 0.0), 4.5);
+}
+
+TEST(SoaVector, PopBackAndClear)
+{
+    auto vec = soa_vector<type_list<int, double>>{};
+    vec.emplace_back(1, 0.5);
+    vec.emplace_back(2, 1.5);
+    vec.pop_back();
+    ASSERT_EQ(vec.size(), 1u);
+    EXPECT_EQ(vec.column<1>().size(), 1u);
+    vec.clear();
+    EXPECT_TRUE(vec.empty());
+    EXPECT_TRUE(vec.column<double>().empty());
+}
+
+TEST(SoaVector, EmplaceBackExceptionKeepsColumnsAligned)
+{
+    auto vec = soa_vector<type_list<int, ThrowOnCopy>>{};
+    vec.emplace_back(1, ThrowOnCopy{});
+    auto value = ThrowOnCopy{};
+    EXPECT_THROW(vec.emplace_back(2, value), std::runtime_error);
+    ASSERT_EQ(vec.size(), 1u);
+    EXPECT_EQ(vec.column<0>().size(), 1u);
+    EXPECT_EQ(vec.column<1>().size(), 1u);
+}
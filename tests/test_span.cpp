@@ -0,0 +1,67 @@
+#include <sfun/span.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <numeric>
+#include <vector>
+
+using namespace sfun;
+
+TEST(Span, Access)
+{
+    auto array = std::array<int, 3>{1, 2, 3};
+    auto view = span<int>{array.data(), array.size()};
+    ASSERT_EQ(view.size(), 3u);
+    EXPECT_FALSE(view.empty());
+    EXPECT_EQ(view.front(), 1);
+    EXPECT_EQ(view[1], 2);
+    EXPECT_EQ(view.back(), 3);
+    EXPECT_EQ(std::accumulate(view.begin(), view.end(), 0), 6);
+
+    view[1] = 20;
+    EXPECT_EQ(array[1], 20);
+}
+
+TEST(Span, ConstConversion)
+{
+    auto array = std::array<int, 2>{1, 2};
+    auto view = span<int>{array.data(), array.size()};
+    span<const int> constView = view;
+    EXPECT_EQ(constView.data(), array.data());
+    EXPECT_EQ(constView.size(), 2u);
+}
+
+TEST(Span, Empty)
+{
+    auto view = span<int>{};
+    EXPECT_TRUE(view.empty());
+    EXPECT_EQ(view.size(), 0u);
+    EXPECT_EQ(view.begin(), view.end());
+}
+
+TEST(Span, FromContainers)
+{
+    auto vector = std::vector<int>{1, 2, 3};
+    span<int> vectorView = vector;
+    EXPECT_EQ(vectorView.data(), vector.data());
+    EXPECT_EQ(vectorView.size(), 3u);
+
+    const auto array = std::array<int, 2>{1, 2};
+    span<const int> arrayView = array;
+    EXPECT_EQ(arrayView.data(), array.data());
+    EXPECT_EQ(arrayView.size(), 2u);
+
+    int cArray[] = {1, 2, 3, 4};
+    auto cArrayView = span{cArray};
+    static_assert(std::is_same_v<decltype(cArrayView), span<int>>);
+    EXPECT_EQ(cArrayView.size(), 4u);
+
+    auto deducedView = span{array};
+    static_assert(std::is_same_v<decltype(deducedView), span<const int>>);
+    EXPECT_EQ(deducedView.back(), 2);
+}
+
+static_assert(std::is_convertible_v<std::vector<int>&, span<const int>>);
+static_assert(std::is_convertible_v<std::vector<int>&&, span<const int>>);
+static_assert(!std::is_convertible_v<std::vector<int>&&, span<int>>);
+static_assert(!std::is_convertible_v<const std::vector<int>&, span<int>>);
+static_assert(!std::is_convertible_v<std::vector<long>&, span<int>>);
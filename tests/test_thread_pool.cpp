@@ -0,0 +1,172 @@
+#include <sfun/thread_pool.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace sfun;
+
+TEST(ThreadPool, Submit)
+{
+    auto pool = thread_pool{4};
+    EXPECT_EQ(pool.thread_count(), 4);
+    auto handle = pool.submit(
+            []
+            {
+                return std::string{"result"};
+            });
+    EXPECT_EQ(handle.get(), "result");
+    EXPECT_TRUE(handle.is_ready());
+}
+
+TEST(ThreadPool, GetReturnsValue)
+{
+    auto pool = thread_pool{2};
+    auto makeString = []
+    {
+        return std::string(100, 'x');
+    };
+    auto&& value = pool.submit(makeString).get();
+    EXPECT_EQ(value, std::string(100, 'x'));
+
+    auto handle = pool.submit(
+            []
+            {
+                return std::string{"result"};
+            });
+    EXPECT_EQ(handle.result().value(), "result");
+    EXPECT_EQ(handle.result().value(), "result");
+    static_assert(std::is_same_v<decltype(handle.get()), std::string>);
+}
+
+TEST(ThreadPool, SubmitVoid)
+{
+    auto pool = thread_pool{2};
+    auto value = std::atomic<int>{};
+    auto handle = pool.submit(
+            [&value]
+            {
+                value = 42;
+            });
+    handle.wait();
+    EXPECT_TRUE(handle.result());
+    EXPECT_EQ(value, 42);
+}
+
+TEST(ThreadPool, SubmitException)
+{
+    auto pool = thread_pool{2};
+    auto handle = pool.submit(
+            []() -> int
+            {
+                throw std::runtime_error{"error"};
+            });
+    ASSERT_FALSE(handle.result());
+    EXPECT_THROW(handle.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, ManyTasks)
+{
+    auto pool = thread_pool{4};
+    auto handles = std::vector<task_handle<int>>{};
+    for (auto i = 0; i < 1000; ++i)
+        handles.push_back(pool.submit(
+                [i]
+                {
+                    return i * 2;
+                }));
+    auto sum = 0;
+    for (auto& handle : handles)
+        sum += handle.get();
+    EXPECT_EQ(sum, 999 * 1000);
+}
+
+TEST(ThreadPool, ParallelFor)
+{
+    auto pool = thread_pool{4};
+    auto values = std::vector<int>(10000);
+    pool.parallel_for(
+            0,
+            ssize(values),
+            64,
+            [&values](index_t i)
+            {
+                values[static_cast<std::size_t>(i)] = static_cast<int>(i);
+            });
+    auto expected = std::vector<int>(10000);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(ThreadPool, ParallelForEmptyRange)
+{
+    auto pool = thread_pool{2};
+    auto callCount = 0;
+    pool.parallel_for(
+            5,
+            5,
+            1,
+            [&callCount](index_t)
+            {
+                ++callCount;
+            });
+    EXPECT_EQ(callCount, 0);
+}
+
+TEST(ThreadPool, ParallelForException)
+{
+    auto pool = thread_pool{4};
+    auto run = [&]
+    {
+        pool.parallel_for(
+                0,
+                1000,
+                10,
+                [](index_t i)
+                {
+                    if (i == 500)
+                        throw std::runtime_error{"error"};
+                });
+    };
+    EXPECT_THROW(run(), std::runtime_error);
+}
+
+TEST(ThreadPool, NestedParallelFor)
+{
+    auto pool = thread_pool{4};
+    auto sum = std::atomic<long>{};
+    pool.parallel_for(
+            0,
+            16,
+            1,
+            [&](index_t)
+            {
+                pool.parallel_for(
+                        0,
+                        100,
+                        10,
+                        [&](index_t j)
+                        {
+                            sum += j;
+                        });
+            });
+    EXPECT_EQ(sum, 16 * 4950);
+}
+
+TEST(ThreadPool, SubmitFromTask)
+{
+    auto pool = thread_pool{2};
+    auto handle = pool.submit(
+            [&pool]
+            {
+                auto inner = pool.submit(
+                        []
+                        {
+                            return 21;
+                        });
+                return inner.get() * 2;
+            });
+    EXPECT_EQ(handle.get(), 42);
+}
@@ -1,5 +1,7 @@
 #include <sfun/type_list.h>
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 
 using namespace sfun;
 
@@ -36,3 +38,125 @@ TEST(TypeList, Slice)
     EXPECT_TRUE((std::is_same_v<decltype(list.template slice<1, 2>()), type_list<double, Foo>>));
     EXPECT_TRUE((std::is_same_v<decltype(list.template slice<0, list.size()>()), type_list<int, double, Foo>>));
 }
+
+TEST(TypeList, AtWithDuplicates)
+{
+    auto list = type_list<int, int, double, int>{};
+    EXPECT_TRUE((std::is_same_v<decltype(list.template at<1>())::type, int>));
+    EXPECT_TRUE((std::is_same_v<decltype(list.template at<2>())::type, double>));
+    EXPECT_TRUE((std::is_same_v<decltype(list.template at<3>())::type, int>));
+    EXPECT_TRUE((std::is_same_v<decltype(list.template slice<1, 3>()), type_list<int, double, int>>));
+}
+
+TEST(TypeList, Contains)
+{
+    auto list = type_list<int, double, Foo>{};
+    EXPECT_TRUE(list.contains<int>());
+    EXPECT_TRUE(list.contains<Foo>());
+    EXPECT_FALSE(list.contains<float>());
+    EXPECT_FALSE(type_list<>::contains<int>());
+}
+
+TEST(TypeList, IndexOf)
+{
+    auto list = type_list<int, double, Foo, double>{};
+    EXPECT_EQ(list.index_of<int>(), 0u);
+    EXPECT_EQ(list.index_of<double>(), 1u);
+    EXPECT_EQ(list.index_of<Foo>(), 2u);
+}
+
+TEST(TypeList, Concat)
+{
+    EXPECT_TRUE((std::is_same_v<decltype(concat()), type_list<>>));
+    EXPECT_TRUE((std::is_same_v<decltype(concat(type_list<int>{})), type_list<int>>));
+    EXPECT_TRUE((std::is_same_v<
+                 decltype(concat(type_list<int, double>{}, type_list<>{}, type_list<Foo>{}, type_list<int>{})),
+                 type_list<int, double, Foo, int>>));
+}
+
+TEST(TypeList, Transform)
+{
+    auto list = type_list<int, double, Foo>{};
+    EXPECT_TRUE((std::is_same_v<decltype(list.transform<std::add_pointer_t>()), type_list<int*, double*, Foo*>>));
+    EXPECT_TRUE((std::is_same_v<decltype(type_list<>::transform<std::add_pointer_t>()), type_list<>>));
+}
+
+TEST(TypeList, Filter)
+{
+    auto list = type_list<int, double, Foo, char, float>{};
+    EXPECT_TRUE((std::is_same_v<decltype(list.filter<std::is_integral>()), type_list<int, char>>));
+    EXPECT_TRUE((std::is_same_v<decltype(list.filter<std::is_arithmetic>()), type_list<int, double, char, float>>));
+    EXPECT_TRUE((std::is_same_v<decltype(list.filter<std::is_void>()), type_list<>>));
+    EXPECT_TRUE((std::is_same_v<decltype(type_list<>::filter<std::is_integral>()), type_list<>>));
+}
+
+TEST(TypeList, Unique)
+{
+    auto list = type_list<int, double, int, Foo, double, int>{};
+    EXPECT_TRUE((std::is_same_v<decltype(list.unique()), type_list<int, double, Foo>>));
+    EXPECT_TRUE((std::is_same_v<decltype(type_list<int, double>::unique()), type_list<int, double>>));
+    EXPECT_TRUE((std::is_same_v<decltype(type_list<>::unique()), type_list<>>));
+}
+
+TEST(TypeList, VisitIndex)
+{
+    using list = type_list<int, double, Foo>;
+    auto typeName = [](auto type) -> std::string
+    {
+        using T = typename decltype(type)::type;
+        if constexpr (std::is_same_v<T, int>)
+            return "int";
+        else if constexpr (std::is_same_v<T, double>)
+            return "double";
+        else
+            return "Foo";
+    };
+    EXPECT_EQ(visit_index<list>(0, typeName), "int");
+    EXPECT_EQ(visit_index<list>(1, typeName), "double");
+    EXPECT_EQ(visit_index<list>(2, typeName), "Foo");
+    EXPECT_EQ(visit_index<list>(trusted_index, 2, typeName), "Foo");
+}
+
+TEST(TypeList, VisitIndexLargeList)
+{
+    using list = type_list<char, short, int, long, float, double, Foo, bool, unsigned, long long>;
+    auto typeSize = [](auto type)
+    {
+        return sizeof(typename decltype(type)::type);
+    };
+    for (auto i = std::size_t{}; i < static_cast<std::size_t>(list::size()); ++i)
+        EXPECT_EQ(visit_index<list>(i, typeSize), visit_index<list>(trusted_index, i, typeSize));
+    EXPECT_EQ(visit_index<list>(0, typeSize), sizeof(char));
+    EXPECT_EQ(visit_index<list>(6, typeSize), sizeof(Foo));
+    EXPECT_EQ(visit_index<list>(9, typeSize), sizeof(long long));
+}
+
+TEST(TypeList, VisitIndexConstexpr)
+{
+    using list = type_list<char, int, double>;
+    constexpr auto size = visit_index<list>(
+            2,
+            [](auto type)
+            {
+                return sizeof(typename decltype(type)::type);
+            });
+    EXPECT_EQ(size, sizeof(double));
+}
+
+TEST(TypeList, ForEachType)
+{
+    auto sizes = std::vector<std::size_t>{};
+    for_each_type<type_list<char, int, Foo>>(
+            [&](auto type)
+            {
+                sizes.push_back(sizeof(typename decltype(type)::type));
+            });
+    EXPECT_EQ(sizes, (std::vector<std::size_t>{sizeof(char), sizeof(int), sizeof(Foo)}));
+
+    for_each_type<type_list<>>(
+            [&](auto)
+            {
+                sizes.clear();
+            });
+    EXPECT_EQ(sizes.size(), 3u);
+}
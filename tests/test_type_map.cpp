@@ -0,0 +1,56 @@
+#include <sfun/type_map.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+
+using namespace sfun;
+
+namespace {
+struct Position {};
+struct Velocity {};
+struct Health {};
+using components = type_list<Position, Velocity, Health>;
+} //namespace
+
+TEST(TypeMap, TypeIndexOf)
+{
+    static_assert(type_index_of<Position, components> == 0);
+    static_assert(type_index_of<Velocity, components> == 1);
+    static_assert(type_index_of<Health, components> == 2);
+    static_assert(type_index_of<int, type_list<double, int, int>> == 1);
+}
+
+TEST(TypeMap, Get)
+{
+    auto map = type_map<components, std::string>{};
+    EXPECT_EQ(map.size(), 3u);
+    map.get<Position>() = "position";
+    map.get<Health>() = "health";
+    EXPECT_EQ(map.get<Position>(), "position");
+    EXPECT_EQ(map.get<Velocity>(), "");
+    EXPECT_EQ(map.get<Health>(), "health");
+    EXPECT_EQ(map[map.index_of<Health>()], "health");
+
+    const auto& constMap = map;
+    EXPECT_EQ(constMap.get<Position>(), "position");
+    EXPECT_EQ(constMap[0], "position");
+}
+
+TEST(TypeMap, FillAndIterate)
+{
+    auto map = type_map<components, int>{2};
+    map.get<Velocity>() = 3;
+    EXPECT_EQ(std::accumulate(map.begin(), map.end(), 0), 7);
+}
+
+TEST(TypeMap, Constexpr)
+{
+    constexpr auto map = []
+    {
+        auto result = type_map<components, int>{};
+        result.get<Velocity>() = 42;
+        return result;
+    }();
+    static_assert(map.get<Velocity>() == 42);
+    static_assert(map.get<Position>() == 0);
+}
@@ -1,5 +1,9 @@
 #include <sfun/utility.h>
 #include <gtest/gtest.h>
+#include <array>
+#include <string>
+#include <tuple>
+#include <vector>
 
 using namespace sfun;
 
@@ -21,3 +25,79 @@ TEST(Utility, IndexRange)
         EXPECT_TRUE((std::is_same_v<range, std::index_sequence<>>));
     }
 }
+
+TEST(Utility, StaticFor)
+{
+    auto indices = std::vector<std::size_t>{};
+    static_for<2, 5>(
+            [&](auto i)
+            {
+                static_assert(decltype(i)::value >= 2 && decltype(i)::value < 5);
+                indices.push_back(i);
+            });
+    EXPECT_EQ(indices, (std::vector<std::size_t>{2, 3, 4}));
+
+    static_for<3, 3>(
+            [&](auto)
+            {
+                indices.clear();
+            });
+    EXPECT_EQ(indices.size(), 3u);
+}
+
+namespace {
+constexpr std::size_t sumOfIndices()
+{
+    auto result = std::size_t{};
+    static_for<0, 5>(
+            [&](auto i)
+            {
+                result += i;
+            });
+    return result;
+}
+} //namespace
+
+TEST(Utility, StaticForConstexpr)
+{
+    static_assert(sumOfIndices() == 10);
+}
+
+TEST(Utility, TupleForEach)
+{
+    auto tuple = std::tuple{1, std::string{"two"}, 3.0};
+    auto result = std::string{};
+    tuple_for_each(
+            tuple,
+            [&](const auto& value)
+            {
+                if constexpr (std::is_same_v<std::decay_t<decltype(value)>, std::string>)
+                    result += value;
+                else
+                    result += std::to_string(static_cast<int>(value));
+            });
+    EXPECT_EQ(result, "1two3");
+
+    tuple_for_each(
+            tuple,
+            [](auto& value)
+            {
+                value += value;
+            });
+    EXPECT_EQ(std::get<0>(tuple), 2);
+    EXPECT_EQ(std::get<1>(tuple), "twotwo");
+    EXPECT_EQ(std::get<2>(tuple), 6.0);
+}
+
+TEST(Utility, TupleForEachArray)
+{
+    auto array = std::array<int, 3>{1, 2, 3};
+    auto sum = 0;
+    tuple_for_each(
+            array,
+            [&](int value)
+            {
+                sum += value;
+            });
+    EXPECT_EQ(sum, 6);
+}